@@ -0,0 +1,392 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* system */
+#include <pthread.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* own libs */
+#include <lib_convention__mem.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define BENCH__BATCH			64U
+#define BENCH__ROUNDS			20000U
+#define BENCH__MAX_THREADS		64U
+
+#define BENCH__LATENCY_SAMPLES	100000U
+
+#define BENCH__XFER_OBJECTS		1000000U
+#define BENCH__XFER_RING		1024U
+
+#define BENCH__FRAG_SLOTS		20000U
+#define BENCH__FRAG_STEPS		2000000U
+#define BENCH__FRAG_REPORTS		10U
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+struct bench_alloc {
+	const char *name;
+	void* (*alloc)(unsigned int _count, size_t _size);
+	void (*release)(void *_mem);
+};
+
+struct bench_thread {
+	pthread_t thread;
+	const struct bench_alloc *alloc;
+	uint32_t seed;
+};
+
+/* single producer / single consumer ring used to free objects on another thread */
+struct bench_xfer {
+	const struct bench_alloc *alloc;
+	void *ring[BENCH__XFER_RING];
+	unsigned int head;
+	unsigned int tail;
+};
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static void* bench__calloc(unsigned int _count, size_t _size);
+static inline uint32_t bench__rand(uint32_t *_seed);
+static inline uint64_t bench__now_ns(void);
+static int bench__cmp_u64(const void *_a, const void *_b);
+static void bench__latency(const struct bench_alloc *_alloc, size_t _size);
+static void* bench__scaling_worker(void *_arg);
+static void bench__scaling(const struct bench_alloc *_alloc, unsigned int _threads);
+static void* bench__xfer_producer(void *_arg);
+static void* bench__xfer_consumer(void *_arg);
+static void bench__xfer(const struct bench_alloc *_alloc);
+static size_t bench__rss(void);
+static void bench__fragmentation(const struct bench_alloc *_alloc);
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+static const struct bench_alloc s_allocs[] = {
+	{ "calloc",			bench__calloc,	free },
+	{ "alloc_memory",	alloc_memory,	free_memory }
+};
+
+static const size_t s_latency_sizes[] = { 16, 64, 256, 1024, 4096, 32768 };
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Allocator benchmark and stress suite
+ *
+ * 	Every result is printed as one JSON object per line, so runs of
+ * 	different releases can be compared by scripts.
+ *
+ * 	usage: lib_convention_bench [max_threads]
+ * ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	unsigned int max_threads, threads, i, k;
+
+	max_threads = (argc > 1) ? (unsigned int)atoi(argv[1]) : (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+	if ((max_threads == 0) || (max_threads > BENCH__MAX_THREADS)) {
+		max_threads = BENCH__MAX_THREADS;
+	}
+
+	for (i = 0; i < sizeof(s_allocs) / sizeof(s_allocs[0]); i++) {
+		for (k = 0; k < sizeof(s_latency_sizes) / sizeof(s_latency_sizes[0]); k++) {
+			bench__latency(&s_allocs[i], s_latency_sizes[k]);
+		}
+		for (threads = 1; threads <= max_threads; threads++) {
+			bench__scaling(&s_allocs[i], threads);
+		}
+		bench__xfer(&s_allocs[i]);
+		bench__fragmentation(&s_allocs[i]);
+	}
+	return 0;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static void* bench__calloc(unsigned int _count, size_t _size)
+{
+	return calloc(_count, _size);
+}
+
+static inline uint32_t bench__rand(uint32_t *_seed)
+{
+	/* xorshift keeps the size mix identical for every allocator */
+	*_seed ^= *_seed << 13;
+	*_seed ^= *_seed >> 17;
+	*_seed ^= *_seed << 5;
+	return *_seed;
+}
+
+static inline uint64_t bench__now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static int bench__cmp_u64(const void *_a, const void *_b)
+{
+	uint64_t a = *(const uint64_t*)_a;
+	uint64_t b = *(const uint64_t*)_b;
+
+	return (a > b) - (a < b);
+}
+
+/* single thread latency percentiles of alloc and free, the clock overhead is subtracted */
+static void bench__latency(const struct bench_alloc *_alloc, size_t _size)
+{
+	static uint64_t lat_alloc[BENCH__LATENCY_SAMPLES];
+	static uint64_t lat_free[BENCH__LATENCY_SAMPLES];
+	static void *mem[BENCH__BATCH];
+	uint64_t t0, t1, overhead = UINT64_MAX;
+	unsigned int i, n;
+
+	for (i = 0; i < 1000; i++) {
+		t0 = bench__now_ns();
+		t1 = bench__now_ns();
+		if ((t1 - t0) < overhead) {
+			overhead = t1 - t0;
+		}
+	}
+
+	for (n = 0; n < BENCH__LATENCY_SAMPLES; n += BENCH__BATCH) {
+		for (i = 0; i < BENCH__BATCH; i++) {
+			t0 = bench__now_ns();
+			mem[i] = _alloc->alloc(1, _size);
+			t1 = bench__now_ns();
+			if ((n + i) < BENCH__LATENCY_SAMPLES) {
+				lat_alloc[n + i] = ((t1 - t0) > overhead) ? (t1 - t0 - overhead) : 0;
+			}
+		}
+		for (i = 0; i < BENCH__BATCH; i++) {
+			t0 = bench__now_ns();
+			_alloc->release(mem[i]);
+			t1 = bench__now_ns();
+			if ((n + i) < BENCH__LATENCY_SAMPLES) {
+				lat_free[n + i] = ((t1 - t0) > overhead) ? (t1 - t0 - overhead) : 0;
+			}
+		}
+	}
+
+	qsort(lat_alloc, BENCH__LATENCY_SAMPLES, sizeof(uint64_t), bench__cmp_u64);
+	qsort(lat_free, BENCH__LATENCY_SAMPLES, sizeof(uint64_t), bench__cmp_u64);
+
+#define BENCH__PCT(_lat, _p)	(_lat)[(size_t)((BENCH__LATENCY_SAMPLES - 1) * (_p))]
+	printf("{\"bench\":\"latency\",\"allocator\":\"%s\",\"op\":\"alloc\",\"size\":%zu,"
+		   "\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu}\n",
+		   _alloc->name, _size,
+		   (unsigned long long)BENCH__PCT(lat_alloc, 0.5), (unsigned long long)BENCH__PCT(lat_alloc, 0.9),
+		   (unsigned long long)BENCH__PCT(lat_alloc, 0.99), (unsigned long long)BENCH__PCT(lat_alloc, 0.999));
+	printf("{\"bench\":\"latency\",\"allocator\":\"%s\",\"op\":\"free\",\"size\":%zu,"
+		   "\"p50_ns\":%llu,\"p90_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu}\n",
+		   _alloc->name, _size,
+		   (unsigned long long)BENCH__PCT(lat_free, 0.5), (unsigned long long)BENCH__PCT(lat_free, 0.9),
+		   (unsigned long long)BENCH__PCT(lat_free, 0.99), (unsigned long long)BENCH__PCT(lat_free, 0.999));
+#undef BENCH__PCT
+}
+
+static void* bench__scaling_worker(void *_arg)
+{
+	struct bench_thread *ctx = (struct bench_thread*)_arg;
+	void *mem[BENCH__BATCH];
+	uint32_t seed = ctx->seed;
+	unsigned int round, i;
+
+	for (round = 0; round < BENCH__ROUNDS; round++) {
+		for (i = 0; i < BENCH__BATCH; i++) {
+			mem[i] = ctx->alloc->alloc(1, 16 + (bench__rand(&seed) % 496));
+		}
+		for (i = 0; i < BENCH__BATCH; i++) {
+			ctx->alloc->release(mem[i]);
+		}
+	}
+	return NULL;
+}
+
+/* alloc/free throughput of _threads independent threads */
+static void bench__scaling(const struct bench_alloc *_alloc, unsigned int _threads)
+{
+	struct bench_thread ctx[BENCH__MAX_THREADS];
+	uint64_t start, elapsed;
+	unsigned int i;
+
+	start = bench__now_ns();
+	for (i = 0; i < _threads; i++) {
+		ctx[i].alloc = _alloc;
+		ctx[i].seed = 0x9E3779B9U + i;
+		pthread_create(&ctx[i].thread, NULL, bench__scaling_worker, &ctx[i]);
+	}
+	for (i = 0; i < _threads; i++) {
+		pthread_join(ctx[i].thread, NULL);
+	}
+	elapsed = bench__now_ns() - start;
+
+	printf("{\"bench\":\"scaling\",\"allocator\":\"%s\",\"threads\":%u,\"ops_per_s\":%.0f}\n",
+		   _alloc->name, _threads,
+		   ((double)_threads * BENCH__ROUNDS * BENCH__BATCH * 2.0) / ((double)elapsed * 1e-9));
+}
+
+static void* bench__xfer_producer(void *_arg)
+{
+	struct bench_xfer *xfer = (struct bench_xfer*)_arg;
+	uint32_t seed = 0x2545F491U;
+	unsigned int n, head;
+
+	for (n = 0; n < BENCH__XFER_OBJECTS; n++) {
+		head = xfer->head;
+		while ((head - __atomic_load_n(&xfer->tail, __ATOMIC_ACQUIRE)) == BENCH__XFER_RING) {
+			sched_yield();
+		}
+		xfer->ring[head % BENCH__XFER_RING] = xfer->alloc->alloc(1, 16 + (bench__rand(&seed) % 240));
+		__atomic_store_n(&xfer->head, head + 1, __ATOMIC_RELEASE);
+	}
+	return NULL;
+}
+
+static void* bench__xfer_consumer(void *_arg)
+{
+	struct bench_xfer *xfer = (struct bench_xfer*)_arg;
+	unsigned int n, tail;
+
+	for (n = 0; n < BENCH__XFER_OBJECTS; n++) {
+		tail = xfer->tail;
+		while (__atomic_load_n(&xfer->head, __ATOMIC_ACQUIRE) == tail) {
+			sched_yield();
+		}
+		xfer->alloc->release(xfer->ring[tail % BENCH__XFER_RING]);
+		__atomic_store_n(&xfer->tail, tail + 1, __ATOMIC_RELEASE);
+	}
+	return NULL;
+}
+
+/* objects are allocated on one thread and released on another */
+static void bench__xfer(const struct bench_alloc *_alloc)
+{
+	static struct bench_xfer xfer;
+	pthread_t producer, consumer;
+	uint64_t start, elapsed;
+
+	memset(&xfer, 0, sizeof(xfer));
+	xfer.alloc = _alloc;
+
+	start = bench__now_ns();
+	pthread_create(&producer, NULL, bench__xfer_producer, &xfer);
+	pthread_create(&consumer, NULL, bench__xfer_consumer, &xfer);
+	pthread_join(producer, NULL);
+	pthread_join(consumer, NULL);
+	elapsed = bench__now_ns() - start;
+
+	printf("{\"bench\":\"producer_consumer\",\"allocator\":\"%s\",\"objects\":%u,\"objects_per_s\":%.0f}\n",
+		   _alloc->name, BENCH__XFER_OBJECTS, (double)BENCH__XFER_OBJECTS / ((double)elapsed * 1e-9));
+}
+
+static size_t bench__rss(void)
+{
+	unsigned long size = 0, resident = 0;
+	FILE *f;
+
+	f = fopen("/proc/self/statm", "r");
+	if (f == NULL) {
+		return 0;
+	}
+	if (fscanf(f, "%lu %lu", &size, &resident) != 2) {
+		resident = 0;
+	}
+	fclose(f);
+	return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+/* random replacement of a working set with a log-uniform size mix, runs in a
+ * child process so the RSS of the other allocators does not interfere */
+static void bench__fragmentation(const struct bench_alloc *_alloc)
+{
+	void **slot;
+	size_t *size;
+	size_t live = 0, rss_base, rss;
+	uint32_t seed = 0x6C078965U;
+	unsigned int step, idx;
+	pid_t pid;
+
+	fflush(stdout);
+	pid = fork();
+	if (pid != 0) {
+		if (pid > 0) {
+			waitpid(pid, NULL, 0);
+		}
+		return;
+	}
+
+	slot = (void**)calloc(BENCH__FRAG_SLOTS, sizeof(void*));
+	size = (size_t*)calloc(BENCH__FRAG_SLOTS, sizeof(size_t));
+	if ((slot == NULL) || (size == NULL)) {
+		_exit(1);
+	}
+	rss_base = bench__rss();
+
+	for (step = 1; step <= BENCH__FRAG_STEPS; step++) {
+		idx = bench__rand(&seed) % BENCH__FRAG_SLOTS;
+		if (slot[idx] != NULL) {
+			_alloc->release(slot[idx]);
+			live -= size[idx];
+		}
+		/* 16 B .. 128 KiB - 1, a power of two plus up to the same again */
+		size[idx] = (size_t)16 << (bench__rand(&seed) % 13);
+		size[idx] += bench__rand(&seed) % size[idx];
+		slot[idx] = _alloc->alloc(1, size[idx]);
+		live += size[idx];
+
+		if ((step % (BENCH__FRAG_STEPS / BENCH__FRAG_REPORTS)) == 0) {
+			/* the RSS may drop below the baseline, e.g. after a trim */
+			rss = bench__rss();
+			rss = (rss > rss_base) ? (rss - rss_base) : 0;
+			printf("{\"bench\":\"fragmentation\",\"allocator\":\"%s\",\"step\":%u,"
+				   "\"live_bytes\":%zu,\"rss_bytes\":%zu,\"overhead\":%.3f}\n",
+				   _alloc->name, step, live, rss, (double)rss / (double)live);
+		}
+	}
+	fflush(stdout);
+	_exit(0);
+}
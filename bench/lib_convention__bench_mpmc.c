@@ -0,0 +1,287 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* system */
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__mem.h>
+#include <lib_convention__mpmc.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define BENCH__ITEMS			2000000U
+#define BENCH__QUEUE_SIZE		1024U
+#define BENCH__BULK				16U
+#define BENCH__MAX_THREADS		64U
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* reference queue, a ring guarded by a mutex */
+struct bench_locked {
+	pthread_mutex_t lock;
+	void *ring[BENCH__QUEUE_SIZE];
+	unsigned int head;
+	unsigned int tail;
+};
+
+struct bench_queue {
+	const char *name;
+	int (*push)(void *_queue, void *const *_items, unsigned int _count);
+	int (*pop)(void *_queue, void **_items, unsigned int _count);
+	unsigned int batch;
+};
+
+struct bench_run {
+	const struct bench_queue *queue;
+	void *ctx;
+	unsigned int items;
+	uint64_t sum;
+};
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static inline uint64_t bench__now_ns(void);
+static int bench__locked_push(void *_queue, void *const *_items, unsigned int _count);
+static int bench__locked_pop(void *_queue, void **_items, unsigned int _count);
+static int bench__mpmc_push(void *_queue, void *const *_items, unsigned int _count);
+static int bench__mpmc_pop(void *_queue, void **_items, unsigned int _count);
+static int bench__mpmc_push_bulk(void *_queue, void *const *_items, unsigned int _count);
+static int bench__mpmc_pop_bulk(void *_queue, void **_items, unsigned int _count);
+static void* bench__producer(void *_arg);
+static void* bench__consumer(void *_arg);
+static void bench__contention(const struct bench_queue *_queue, unsigned int _threads);
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+static const struct bench_queue s_queues[] = {
+	{ "mutex",		bench__locked_push,		bench__locked_pop,		1U },
+	{ "mpmc",		bench__mpmc_push,		bench__mpmc_pop,		1U },
+	{ "mutex_bulk",	bench__locked_push,		bench__locked_pop,		BENCH__BULK },
+	{ "mpmc_bulk",	bench__mpmc_push_bulk,	bench__mpmc_pop_bulk,	BENCH__BULK }
+};
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Queue contention benchmark
+ *
+ * 	Equal numbers of producers and consumers pass BENCH__ITEMS items
+ * 	through a mutex guarded ring and through the lock-free queue. Every
+ * 	result is printed as one JSON object per line.
+ *
+ * 	usage: lib_convention_bench_mpmc [max_threads]
+ * ****************************************************************************/
+int main(int argc, char *argv[])
+{
+	unsigned int max_threads, threads, i;
+
+	max_threads = (argc > 1) ? (unsigned int)atoi(argv[1]) : (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+	if ((max_threads < 2) || (max_threads > BENCH__MAX_THREADS)) {
+		max_threads = (max_threads < 2) ? 2 : BENCH__MAX_THREADS;
+	}
+
+	for (i = 0; i < sizeof(s_queues) / sizeof(s_queues[0]); i++) {
+		for (threads = 2; threads <= max_threads; threads *= 2) {
+			bench__contention(&s_queues[i], threads);
+		}
+	}
+	return 0;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static inline uint64_t bench__now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static int bench__locked_push(void *_queue, void *const *_items, unsigned int _count)
+{
+	struct bench_locked *queue = (struct bench_locked*)_queue;
+	unsigned int n = 0;
+
+	pthread_mutex_lock(&queue->lock);
+	while ((n < _count) && ((queue->head - queue->tail) < BENCH__QUEUE_SIZE)) {
+		queue->ring[queue->head++ % BENCH__QUEUE_SIZE] = _items[n++];
+	}
+	pthread_mutex_unlock(&queue->lock);
+	return (n != 0) ? (int)n : -ELIST_OVERFLOW;
+}
+
+static int bench__locked_pop(void *_queue, void **_items, unsigned int _count)
+{
+	struct bench_locked *queue = (struct bench_locked*)_queue;
+	unsigned int n = 0;
+
+	pthread_mutex_lock(&queue->lock);
+	while ((n < _count) && (queue->head != queue->tail)) {
+		_items[n++] = queue->ring[queue->tail++ % BENCH__QUEUE_SIZE];
+	}
+	pthread_mutex_unlock(&queue->lock);
+	return (n != 0) ? (int)n : -ESTD_AGAIN;
+}
+
+static int bench__mpmc_push(void *_queue, void *const *_items, unsigned int _count)
+{
+	(void)_count;
+	return (mpmc_queue__push((struct mpmc_queue*)_queue, _items[0]) == EOK) ? 1 : -ELIST_OVERFLOW;
+}
+
+static int bench__mpmc_pop(void *_queue, void **_items, unsigned int _count)
+{
+	(void)_count;
+	return (mpmc_queue__pop((struct mpmc_queue*)_queue, &_items[0]) == EOK) ? 1 : -ESTD_AGAIN;
+}
+
+static int bench__mpmc_push_bulk(void *_queue, void *const *_items, unsigned int _count)
+{
+	return mpmc_queue__push_bulk((struct mpmc_queue*)_queue, _items, _count);
+}
+
+static int bench__mpmc_pop_bulk(void *_queue, void **_items, unsigned int _count)
+{
+	return mpmc_queue__pop_bulk((struct mpmc_queue*)_queue, _items, _count);
+}
+
+static void* bench__producer(void *_arg)
+{
+	struct bench_run *run = (struct bench_run*)_arg;
+	void *items[BENCH__BULK];
+	unsigned int sent = 0, n, i;
+	int ret;
+
+	while (sent < run->items) {
+		n = run->items - sent;
+		n = (n < run->queue->batch) ? n : run->queue->batch;
+		for (i = 0; i < n; i++) {
+			items[i] = (void*)(uintptr_t)(sent + i + 1U);
+		}
+		for (i = 0; i < n; i += (unsigned int)ret) {
+			while ((ret = run->queue->push(run->ctx, &items[i], n - i)) < 0) {
+				sched_yield();
+			}
+		}
+		sent += n;
+	}
+	return NULL;
+}
+
+static void* bench__consumer(void *_arg)
+{
+	struct bench_run *run = (struct bench_run*)_arg;
+	void *items[BENCH__BULK];
+	unsigned int received = 0, n;
+	int ret, i;
+
+	while (received < run->items) {
+		/* never take items of the share of another consumer, it would wait for them forever */
+		n = run->items - received;
+		n = (n < run->queue->batch) ? n : run->queue->batch;
+		ret = run->queue->pop(run->ctx, items, n);
+		if (ret < 0) {
+			sched_yield();
+			continue;
+		}
+		for (i = 0; i < ret; i++) {
+			run->sum += (uintptr_t)items[i];
+		}
+		received += (unsigned int)ret;
+	}
+	return NULL;
+}
+
+/* _threads / 2 producers pass the items to _threads / 2 consumers */
+static void bench__contention(const struct bench_queue *_queue, unsigned int _threads)
+{
+	static struct bench_locked locked;
+	struct bench_run run[BENCH__MAX_THREADS];
+	pthread_t thread[BENCH__MAX_THREADS];
+	struct mpmc_queue mpmc;
+	unsigned int pairs = _threads / 2, i;
+	uint64_t start, elapsed, sum = 0, expected;
+	void *buffer;
+
+	buffer = alloc_memory_aligned(1, MPMC_QUEUE__BUFFER_SIZE(BENCH__QUEUE_SIZE), MEM__CACHE_LINE);
+	if ((buffer == NULL) ||
+		(mpmc_queue__init(&mpmc, buffer, MPMC_QUEUE__BUFFER_SIZE(BENCH__QUEUE_SIZE), BENCH__QUEUE_SIZE) != EOK)) {
+		fprintf(stderr, "queue setup failed\n");
+		exit(1);
+	}
+	memset(&locked, 0, sizeof(locked));
+	pthread_mutex_init(&locked.lock, NULL);
+
+	for (i = 0; i < _threads; i++) {
+		run[i].queue = _queue;
+		run[i].ctx = (_queue->push == bench__locked_push) ? (void*)&locked : (void*)&mpmc;
+		run[i].items = BENCH__ITEMS / pairs;
+		run[i].sum = 0;
+	}
+
+	start = bench__now_ns();
+	for (i = 0; i < _threads; i++) {
+		pthread_create(&thread[i], NULL, (i < pairs) ? bench__producer : bench__consumer, &run[i]);
+	}
+	for (i = 0; i < _threads; i++) {
+		pthread_join(thread[i], NULL);
+		sum += run[i].sum;
+	}
+	elapsed = bench__now_ns() - start;
+
+	/* every producer sends 1..items, a lost or duplicated item changes the sum */
+	expected = (uint64_t)pairs * run[0].items * (run[0].items + 1U) / 2U;
+	printf("{\"bench\":\"contention\",\"queue\":\"%s\",\"producers\":%u,\"consumers\":%u,"
+		   "\"items_per_s\":%.0f,\"valid\":%s}\n",
+		   _queue->name, pairs, pairs, (double)(pairs * run[0].items) / ((double)elapsed * 1e-9),
+		   (sum == expected) ? "true" : "false");
+
+	pthread_mutex_destroy(&locked.lock);
+	free_memory_aligned(buffer);
+}
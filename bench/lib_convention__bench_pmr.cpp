@@ -0,0 +1,224 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+
+/* c++ runtime */
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* own libs */
+#include <lib_convention__memory_resource.hpp>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define BENCH__ROUNDS			200U
+#define BENCH__ELEMENTS			10000U
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Resource under test, release() is called after every round for
+ * 			the monotonic ones
+ * ****************************************************************************/
+struct bench_resource {
+	const char *name;
+	std::pmr::memory_resource *resource;
+	void (*release)(std::pmr::memory_resource *_resource);
+};
+
+struct bench_workload {
+	const char *name;
+	uint64_t (*run)(std::pmr::memory_resource *_resource, uint32_t _seed);
+};
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static inline uint64_t bench__now_ns(void);
+static inline uint32_t bench__rand(uint32_t *_seed);
+static uint64_t bench__vector(std::pmr::memory_resource *_resource, uint32_t _seed);
+static uint64_t bench__unordered_map(std::pmr::memory_resource *_resource, uint32_t _seed);
+static uint64_t bench__map(std::pmr::memory_resource *_resource, uint32_t _seed);
+static uint64_t bench__list(std::pmr::memory_resource *_resource, uint32_t _seed);
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+static const struct bench_workload s_workloads[] = {
+	{ "vector", bench__vector },
+	{ "unordered_map", bench__unordered_map },
+	{ "map", bench__map },
+	{ "list_string", bench__list },
+};
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int main(void)
+{
+	lib_convention::arena_resource arena;
+	lib_convention::pool_resource pool;
+	std::pmr::monotonic_buffer_resource std_monotonic;
+	std::pmr::unsynchronized_pool_resource std_pool;
+	const struct bench_resource resources[] = {
+		{ "new_delete", std::pmr::new_delete_resource(), nullptr },
+		{ "std_monotonic", &std_monotonic,
+		  [](std::pmr::memory_resource *_r) { static_cast<std::pmr::monotonic_buffer_resource*>(_r)->release(); } },
+		{ "std_pool", &std_pool, nullptr },
+		{ "lib_heap", lib_convention::heap_resource(), nullptr },
+		{ "lib_arena", &arena,
+		  [](std::pmr::memory_resource *_r) { static_cast<lib_convention::arena_resource*>(_r)->release(); } },
+		{ "lib_pool", &pool, nullptr },
+	};
+	uint64_t start, ns, base_ns = 0, check;
+	unsigned int round;
+
+	for (const auto &workload : s_workloads) {
+		for (const auto &res : resources) {
+			/* warm up caches and pools, then measure */
+			check = workload.run(res.resource, 1U);
+			if (res.release != nullptr) {
+				res.release(res.resource);
+			}
+
+			start = bench__now_ns();
+			for (round = 0; round < BENCH__ROUNDS; round++) {
+				check += workload.run(res.resource, round + 1U);
+				if (res.release != nullptr) {
+					res.release(res.resource);
+				}
+			}
+			ns = (bench__now_ns() - start) / BENCH__ROUNDS;
+			if (res.resource == std::pmr::new_delete_resource()) {
+				base_ns = ns;
+			}
+
+			printf("{\"bench\":\"pmr\",\"workload\":\"%s\",\"resource\":\"%s\",\"ns_per_round\":%llu,"
+				   "\"speedup\":%.2f,\"check\":%llu}\n", workload.name, res.name, (unsigned long long)ns,
+				   (ns != 0) ? ((double)base_ns / (double)ns) : 0.0, (unsigned long long)check);
+		}
+	}
+	return 0;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static inline uint64_t bench__now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint32_t bench__rand(uint32_t *_seed)
+{
+	*_seed ^= *_seed << 13;
+	*_seed ^= *_seed >> 17;
+	*_seed ^= *_seed << 5;
+	return *_seed;
+}
+
+/* many short vectors grown element by element */
+static uint64_t bench__vector(std::pmr::memory_resource *_resource, uint32_t _seed)
+{
+	std::pmr::vector<std::pmr::vector<uint32_t>> outer(_resource);
+	uint64_t sum = 0;
+	unsigned int i, j;
+
+	for (i = 0; i < (BENCH__ELEMENTS / 16U); i++) {
+		outer.emplace_back();
+		for (j = 0; j < 16U + (bench__rand(&_seed) % 64U); j++) {
+			outer.back().push_back(j);
+		}
+		sum += outer.back().size();
+	}
+	return sum;
+}
+
+static uint64_t bench__unordered_map(std::pmr::memory_resource *_resource, uint32_t _seed)
+{
+	std::pmr::unordered_map<uint32_t, uint64_t> map(_resource);
+	uint64_t sum = 0;
+	unsigned int i;
+
+	for (i = 0; i < BENCH__ELEMENTS; i++) {
+		map[bench__rand(&_seed) % (BENCH__ELEMENTS * 4U)] += i;
+	}
+	for (i = 0; i < BENCH__ELEMENTS; i += 2U) {
+		map.erase(bench__rand(&_seed) % (BENCH__ELEMENTS * 4U));
+	}
+	for (const auto &entry : map) {
+		sum += entry.second;
+	}
+	return sum + map.size();
+}
+
+static uint64_t bench__map(std::pmr::memory_resource *_resource, uint32_t _seed)
+{
+	std::pmr::map<uint32_t, uint32_t> map(_resource);
+	unsigned int i;
+
+	for (i = 0; i < BENCH__ELEMENTS; i++) {
+		map.emplace(bench__rand(&_seed), i);
+	}
+	return map.size() + map.begin()->second;
+}
+
+/* strings beyond the small string buffer, allocated per node */
+static uint64_t bench__list(std::pmr::memory_resource *_resource, uint32_t _seed)
+{
+	std::pmr::list<std::pmr::string> list(_resource);
+	uint64_t sum = 0;
+	unsigned int i;
+
+	for (i = 0; i < BENCH__ELEMENTS; i++) {
+		list.emplace_back(32U + (bench__rand(&_seed) % 64U), 'x');
+		if ((i % 4U) == 3U) {
+			list.pop_front();
+		}
+	}
+	for (const auto &str : list) {
+		sum += str.size();
+	}
+	return sum;
+}
@@ -0,0 +1,128 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__ARENA_H_
+#define LIB_CONVENTION__ARENA_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stddef.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Alignment used by mem_arena__alloc() if 0 is passed as _align
+ * ****************************************************************************/
+#define MEM_ARENA__DEFAULT_ALIGN	16U
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+struct mem_arena;
+struct mem_arena_chunk;
+
+/* ************************************************************************//**
+ * \brief	Position inside of an arena recorded by mem_arena__mark()
+ * ****************************************************************************/
+struct mem_arena_mark {
+	struct mem_arena_chunk *chunk;
+	size_t used;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Create an arena for scratch memory with a common lifetime
+ *
+ * 	Memory is taken from alloc_memory() in chunks of _chunk_size bytes.
+ * 	Chunks are kept on mem_arena__reset() and mem_arena__rewind(), so a
+ * 	steady state workload does not call the system allocator anymore.
+ *
+ * \param	_arena		: created arena is passed to this pointer
+ * \param	_chunk_size	: payload size of a chunk in bytes
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_arena__create(struct mem_arena **_arena, size_t _chunk_size);
+
+/* ************************************************************************//**
+ * \brief	Release an arena together with all of its chunks
+ *
+ * \param	_arena		: arena to destroy, set to NULL afterwards
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_arena__destroy(struct mem_arena **_arena);
+
+/* ************************************************************************//**
+ * \brief	Bump-allocate uninitialized memory from an arena
+ *
+ * \param	_arena		: arena to allocate from
+ * \param	_size		: requested number of bytes
+ * \param	_align		: power of two alignment, 0 selects MEM_ARENA__DEFAULT_ALIGN
+ * \return	pointer to the memory, or NULL if out of memory or invalid arguments
+ * ****************************************************************************/
+void* mem_arena__alloc(struct mem_arena *_arena, size_t _size, size_t _align);
+
+/* ************************************************************************//**
+ * \brief	Bump-allocate zero initialized memory from an arena
+ *
+ * \param	_arena		: arena to allocate from
+ * \param	_size		: requested number of bytes
+ * \param	_align		: power of two alignment, 0 selects MEM_ARENA__DEFAULT_ALIGN
+ * \return	pointer to the memory, or NULL if out of memory or invalid arguments
+ * ****************************************************************************/
+void* mem_arena__zalloc(struct mem_arena *_arena, size_t _size, size_t _align);
+
+/* ************************************************************************//**
+ * \brief	Record the current fill level of an arena
+ *
+ * \param	_arena		: arena to investigate
+ * \param	_mark		: fill level is passed to this mark
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_arena__mark(struct mem_arena *_arena, struct mem_arena_mark *_mark);
+
+/* ************************************************************************//**
+ * \brief	Release everything allocated after a mark was taken
+ *
+ * \param	_arena		: arena to rewind
+ * \param	_mark		: mark taken by mem_arena__mark() on the same arena
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_arena__rewind(struct mem_arena *_arena, const struct mem_arena_mark *_mark);
+
+/* ************************************************************************//**
+ * \brief	Release everything allocated from an arena, chunks are kept
+ *
+ * \param	_arena		: arena to reset
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_arena__reset(struct mem_arena *_arena);
+
+#endif /* LIB_CONVENTION__ARENA_H_ */
@@ -0,0 +1,370 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__BITFIELD_HPP_
+#define LIB_CONVENTION__BITFIELD_HPP_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/* system */
+#if defined(__BMI2__)
+	#include <immintrin.h>
+#endif
+
+/* own libs */
+#include <lib_convention__cmd.h>
+
+#if (__cplusplus < 201402L)
+	#error "lib_convention__bitfield.hpp requires C++14"
+#endif
+
+namespace lib_convention {
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Description of a single bit-field
+ *
+ * \param	Shift	: bit number of the lowest bit of the field
+ * \param	Width	: number of bits of the field
+ * ****************************************************************************/
+template <unsigned Shift, unsigned Width>
+struct bit_field {
+	static_assert((Width > 0U) && (Width <= 64U), "width of a bit-field has to be 1..64");
+	static_assert((Shift + Width) <= 64U, "bit-field exceeds 64 bits");
+
+	static constexpr unsigned shift = Shift;
+	static constexpr unsigned width = Width;
+	static constexpr uint64_t value_mask = (Width == 64U) ? ~0ULL : ((1ULL << Width) - 1ULL);
+	static constexpr uint64_t mask = value_mask << Shift;
+};
+
+/* ************************************************************************//**
+ * \brief	Layout of bit-fields packed into one word
+ *
+ * 	The layout is checked at compile time, every field has to fit into
+ * 	Word and no two fields may overlap. All accessors compile to shifts
+ * 	and masks without branches.
+ *
+ * 	gather()/scatter() move a set of fields to or from the low bits of a
+ * 	word, the fields keep their order. With BMI2 (-mbmi2) they map to
+ * 	PEXT/PDEP, otherwise to one shift and mask per field. 64 bit words
+ * 	use PEXT/PDEP only on x86_64.
+ *
+ * 	using reg = bit_layout<uint32_t, bit_field<0, 8>, bit_field<8, 4>>;
+ * 	uint32_t low = reg::get<bit_field<0, 8>>(word);
+ *
+ * \param	Word	: unsigned integer type the fields are packed into
+ * \param	Fields	: bit_field<> descriptions
+ * ****************************************************************************/
+template <typename Word, typename... Fields>
+class bit_layout {
+	static_assert(std::is_integral<Word>::value && std::is_unsigned<Word>::value,
+				  "the word of a bit layout has to be an unsigned integer");
+	static_assert(sizeof...(Fields) > 0U, "a bit layout needs at least one field");
+
+	static constexpr unsigned s_word_bits = sizeof(Word) * 8U;
+	static constexpr uint64_t s_masks[sizeof...(Fields)] = { Fields::mask... };
+	static constexpr unsigned s_ends[sizeof...(Fields)] = { (Fields::shift + Fields::width)... };
+
+	static constexpr bool fits(void)
+	{
+		for (unsigned i = 0; i < sizeof...(Fields); i++) {
+			if (s_ends[i] > s_word_bits) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static constexpr bool disjoint(void)
+	{
+		uint64_t used = 0;
+
+		for (unsigned i = 0; i < sizeof...(Fields); i++) {
+			if ((used & s_masks[i]) != 0) {
+				return false;
+			}
+			used |= s_masks[i];
+		}
+		return true;
+	}
+
+	template <typename Field>
+	static constexpr bool contains(void)
+	{
+		const bool found[] = { std::is_same<Field, Fields>::value... };
+
+		for (unsigned i = 0; i < sizeof...(Fields); i++) {
+			if (found[i]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static constexpr unsigned popcount(uint64_t _val)
+	{
+		unsigned n = 0;
+
+		for (; _val != 0; _val &= _val - 1U) {
+			n++;
+		}
+		return n;
+	}
+
+	template <typename... Sel>
+	static constexpr uint64_t union_mask(void)
+	{
+		const uint64_t masks[] = { 0ULL, Sel::mask... };
+		uint64_t mask = 0;
+
+		for (unsigned i = 0; i < (sizeof...(Sel) + 1U); i++) {
+			mask |= masks[i];
+		}
+		return mask;
+	}
+
+	/* position of a field within the gathered word */
+	template <typename Field, typename... Sel>
+	static constexpr unsigned gather_shift(void)
+	{
+		return popcount(union_mask<Sel...>() & ((1ULL << Field::shift) - 1ULL));
+	}
+
+	static_assert(fits(), "bit-field exceeds the word of the layout");
+	static_assert(disjoint(), "bit-fields of the layout overlap");
+
+public:
+	typedef Word word_type;
+
+	/* ************************************************************************//**
+	 * \brief	Bits covered by all fields of the layout
+	 * ****************************************************************************/
+	static constexpr Word mask = static_cast<Word>(union_mask<Fields...>());
+
+	/* ************************************************************************//**
+	 * \brief	Number of bits of the word returned by gather<Sel...>()
+	 * ****************************************************************************/
+	template <typename... Sel>
+	static constexpr unsigned gather_bits = popcount(union_mask<Sel...>());
+
+	/* ************************************************************************//**
+	 * \brief	Extract a field
+	 *
+	 * \param	_word	: packed word
+	 * \return	value of the field, right aligned
+	 * ****************************************************************************/
+	template <typename Field>
+	static constexpr Word get(Word _word)
+	{
+		static_assert(contains<Field>(), "field is not part of the layout");
+		return static_cast<Word>((static_cast<uint64_t>(_word) >> Field::shift) & Field::value_mask);
+	}
+
+	/* ************************************************************************//**
+	 * \brief	Insert a field, bits of _value above the field width are dropped
+	 *
+	 * \param	_word	: packed word
+	 * \param	_value	: new value of the field
+	 * \return	packed word with the field replaced
+	 * ****************************************************************************/
+	template <typename Field>
+	static constexpr Word set(Word _word, Word _value)
+	{
+		static_assert(contains<Field>(), "field is not part of the layout");
+		return static_cast<Word>((static_cast<uint64_t>(_word) & ~Field::mask) |
+								 ((static_cast<uint64_t>(_value) << Field::shift) & Field::mask));
+	}
+
+	/* ************************************************************************//**
+	 * \brief	Pack a value for every field, in the order of the declaration
+	 *
+	 * \param	_values	: field values, bits above the field width are dropped
+	 * \return	packed word
+	 * ****************************************************************************/
+	template <typename... Values>
+	static constexpr Word pack(Values... _values)
+	{
+		static_assert(sizeof...(Values) == sizeof...(Fields), "one value per field is required");
+		const uint64_t parts[] = { ((static_cast<uint64_t>(_values) << Fields::shift) & Fields::mask)... };
+		uint64_t word = 0;
+
+		for (unsigned i = 0; i < sizeof...(Fields); i++) {
+			word |= parts[i];
+		}
+		return static_cast<Word>(word);
+	}
+
+	/* ************************************************************************//**
+	 * \brief	Concatenate the selected fields into the low bits of a word
+	 *
+	 * 	The lowest selected field ends up in the lowest bits, e.g. as a
+	 * 	dense key for a lookup table.
+	 *
+	 * \param	_word	: packed word
+	 * \return	gathered fields
+	 * ****************************************************************************/
+	template <typename... Sel>
+	static inline Word gather(Word _word)
+	{
+		static_assert(sizeof...(Sel) > 0U, "at least one field has to be selected");
+#if defined(__BMI2__)
+		if (bmi2()) {
+			return pext(_word, static_cast<Word>(union_mask<Sel...>()));
+		}
+#endif
+		const uint64_t parts[] = { (static_cast<uint64_t>(get<Sel>(_word)) << gather_shift<Sel, Sel...>())... };
+		uint64_t word = 0;
+
+		for (unsigned i = 0; i < sizeof...(Sel); i++) {
+			word |= parts[i];
+		}
+		return static_cast<Word>(word);
+	}
+
+	/* ************************************************************************//**
+	 * \brief	Inverse of gather(), distribute low bits to the selected fields
+	 *
+	 * \param	_bits	: gathered fields
+	 * \return	packed word, bits outside of the selected fields are zero
+	 * ****************************************************************************/
+	template <typename... Sel>
+	static inline Word scatter(Word _bits)
+	{
+		static_assert(sizeof...(Sel) > 0U, "at least one field has to be selected");
+#if defined(__BMI2__)
+		if (bmi2()) {
+			return pdep(_bits, static_cast<Word>(union_mask<Sel...>()));
+		}
+#endif
+		const uint64_t parts[] = { (((static_cast<uint64_t>(_bits) >> gather_shift<Sel, Sel...>()) & Sel::value_mask) << Sel::shift)... };
+		uint64_t word = 0;
+
+		for (unsigned i = 0; i < sizeof...(Sel); i++) {
+			word |= parts[i];
+		}
+		return static_cast<Word>(word);
+	}
+
+	/* ************************************************************************//**
+	 * \brief	Extract one field of an array of packed words
+	 *
+	 * 	The loop has no branches and no dependencies between iterations,
+	 * 	so the compiler vectorizes it.
+	 *
+	 * \param	_in		: packed words
+	 * \param	_count	: number of words
+	 * \param	_out	: field values, _count entries
+	 * ****************************************************************************/
+	template <typename Field>
+	static void decode(const Word *_in, size_t _count, Word *_out)
+	{
+		for (size_t i = 0; i < _count; i++) {
+			_out[i] = get<Field>(_in[i]);
+		}
+	}
+
+	/* ************************************************************************//**
+	 * \brief	Gather the selected fields of an array of packed words
+	 *
+	 * \param	_in		: packed words
+	 * \param	_count	: number of words
+	 * \param	_out	: gathered fields, _count entries
+	 * ****************************************************************************/
+	template <typename... Sel>
+	static void gather(const Word *_in, size_t _count, Word *_out)
+	{
+		for (size_t i = 0; i < _count; i++) {
+			_out[i] = gather<Sel...>(_in[i]);
+		}
+	}
+
+private:
+#if defined(__BMI2__)
+	/* the 64 bit forms only exist on x86_64, wider words take the portable loop elsewhere */
+	static constexpr bool bmi2()
+	{
+	#if defined(__x86_64__)
+		return true;
+	#else
+		return (sizeof(Word) <= sizeof(uint32_t));
+	#endif
+	}
+
+	static inline Word pext(Word _word, Word _mask)
+	{
+	#if defined(__x86_64__)
+		if (sizeof(Word) > sizeof(uint32_t)) {
+			return static_cast<Word>(_pext_u64(static_cast<uint64_t>(_word), static_cast<uint64_t>(_mask)));
+		}
+	#endif
+		return static_cast<Word>(_pext_u32(static_cast<uint32_t>(_word), static_cast<uint32_t>(_mask)));
+	}
+
+	static inline Word pdep(Word _bits, Word _mask)
+	{
+	#if defined(__x86_64__)
+		if (sizeof(Word) > sizeof(uint32_t)) {
+			return static_cast<Word>(_pdep_u64(static_cast<uint64_t>(_bits), static_cast<uint64_t>(_mask)));
+		}
+	#endif
+		return static_cast<Word>(_pdep_u32(static_cast<uint32_t>(_bits), static_cast<uint32_t>(_mask)));
+	}
+#endif
+};
+
+template <typename Word, typename... Fields>
+constexpr uint64_t bit_layout<Word, Fields...>::s_masks[];
+
+template <typename Word, typename... Fields>
+constexpr unsigned bit_layout<Word, Fields...>::s_ends[];
+
+template <typename Word, typename... Fields>
+constexpr Word bit_layout<Word, Fields...>::mask;
+
+/* ************************************************************************//**
+ * \brief	Layout of the commands created by M_CONV__CMD__CREATE_CMD()
+ * ****************************************************************************/
+namespace cmd {
+	typedef bit_field<M_CONV__CMD__SHIFT_NR, M_CONV__CMD__BITS_NR>		nr;
+	typedef bit_field<M_CONV__CMD__SHIFT_TYPE, M_CONV__CMD__BITS_TYPE>	type;
+	typedef bit_field<M_CONV__CMD__SHIFT_SIZE, M_CONV__CMD__BITS_SIZE>	size;
+	typedef bit_field<M_CONV__CMD__SHIFT_DIR, M_CONV__CMD__BITS_DIR>	dir;
+
+	typedef bit_layout<uint32_t, nr, type, size, dir> layout;
+}
+
+} /* namespace lib_convention */
+
+#endif /* LIB_CONVENTION__BITFIELD_HPP_ */
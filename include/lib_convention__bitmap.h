@@ -0,0 +1,134 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__BITMAP_H_
+#define LIB_CONVENTION__BITMAP_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib_convention__macro.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Number of bits stored in a single word of the bitmap
+ * ****************************************************************************/
+#define BITMAP__WORD_BITS		64U
+
+/* ************************************************************************//**
+ * \brief	Number of words which have to be supplied for a bitmap
+ *
+ * \param	_bits	: number of bits of the bitmap
+ * ****************************************************************************/
+#define BITMAP__WORDS(_bits)	(((_bits) + BITMAP__WORD_BITS - 1) / BITMAP__WORD_BITS)
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Bitmap of arbitrary length over caller supplied words
+ *
+ * 	Bit n is stored in words[n / 64] at bit position n % 64.
+ * ****************************************************************************/
+struct bitmap {
+	uint64_t *words;
+	size_t bits;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Set up a bitmap with all bits cleared
+ *
+ * \param	_map	: bitmap to initialize
+ * \param	_words	: memory of BITMAP__WORDS(_bits) words
+ * \param	_bits	: number of bits
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int bitmap__init(struct bitmap *_map, uint64_t *_words, size_t _bits);
+
+/* ************************************************************************//**
+ * \brief	Set or clear a range of bits
+ *
+ * \param	_map	: bitmap to modify
+ * \param	_first	: first bit of the range
+ * \param	_count	: number of bits of the range
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int bitmap__set_range(struct bitmap *_map, size_t _first, size_t _count);
+int bitmap__clear_range(struct bitmap *_map, size_t _first, size_t _count);
+
+/* ************************************************************************//**
+ * \brief	Find the first set or cleared bit at or above a start bit
+ *
+ * 	Whole words are scanned with SSE2 or AVX2 if the CPU supports it.
+ *
+ * \param	_map	: bitmap to investigate
+ * \param	_start	: bit to start the search at
+ * \return	number of the found bit, or _map->bits if there is none
+ * ****************************************************************************/
+size_t bitmap__find_first_set(const struct bitmap *_map, size_t _start);
+size_t bitmap__find_first_clear(const struct bitmap *_map, size_t _start);
+
+/* ************************************************************************//**
+ * \brief	Count the set bits of the bitmap
+ *
+ * \param	_map	: bitmap to investigate
+ * \return	number of set bits
+ * ****************************************************************************/
+size_t bitmap__count(const struct bitmap *_map);
+
+/* *******************************************************************
+ * static inline function
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Set, clear or test a single bit, _bit has to be below _map->bits
+ * ****************************************************************************/
+static inline void bitmap__set(struct bitmap *_map, size_t _bit)
+{
+	_map->words[_bit / BITMAP__WORD_BITS] |= 1ULL << (_bit % BITMAP__WORD_BITS);
+}
+
+static inline void bitmap__clear(struct bitmap *_map, size_t _bit)
+{
+	_map->words[_bit / BITMAP__WORD_BITS] &= ~(1ULL << (_bit % BITMAP__WORD_BITS));
+}
+
+static inline int bitmap__test(const struct bitmap *_map, size_t _bit)
+{
+	return (int)((_map->words[_bit / BITMAP__WORD_BITS] >> (_bit % BITMAP__WORD_BITS)) & 1U);
+}
+
+#endif /* LIB_CONVENTION__BITMAP_H_ */
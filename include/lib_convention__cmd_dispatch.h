@@ -0,0 +1,147 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__CMD_DISPATCH_H_
+#define LIB_CONVENTION__CMD_DISPATCH_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib_convention__cmd.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Bits of a command which select the handler (type and number)
+ * ****************************************************************************/
+#define CMD_DISPATCH__KEY(_cmd)		((uint32_t)(_cmd) & (uint32_t)((M_CONV__CMD__MASK_NR << M_CONV__CMD__SHIFT_NR) | \
+																   (M_CONV__CMD__MASK_TYPE << M_CONV__CMD__SHIFT_TYPE)))
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Command handler
+ *
+ * \param	_ctx		: context passed at registration
+ * \param	_cmd		: dispatched command
+ * \param	_arg		: argument of the command, M_CONV__CMD__SIZE(_cmd) bytes
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+typedef int (*cmd_dispatch_handler_t)(void *_ctx, uint32_t _cmd, void *_arg);
+
+/* ************************************************************************//**
+ * \brief	Slot of the dispatch table, also used to describe handlers
+ * 			for cmd_dispatch__build()
+ *
+ * \param	cmd		: command as created by M_CONV__CMD__CREATE_CMD_*(),
+ * 					  direction and size are checked on dispatch
+ * \param	handler	: handler of the command, NULL marks a free slot
+ * \param	ctx		: context passed to the handler
+ * ****************************************************************************/
+struct cmd_dispatch_entry {
+	uint32_t cmd;
+	cmd_dispatch_handler_t handler;
+	void *ctx;
+};
+
+/* ************************************************************************//**
+ * \brief	Dispatcher over a caller supplied table
+ *
+ * 	Commands are hashed on type and number into the table. The number of
+ * 	probes is bounded by max_probe, which cmd_dispatch__build() brings to
+ * 	one by searching a collision free (perfect) hash multiplier.
+ * ****************************************************************************/
+struct cmd_dispatch {
+	struct cmd_dispatch_entry *table;
+	uint32_t mask;
+	uint32_t shift;
+	uint32_t mult;
+	uint32_t count;
+	uint32_t max_probe;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Set up an empty dispatcher
+ *
+ * \param	_disp		: dispatcher to initialize
+ * \param	_table		: slots of the dispatcher
+ * \param	_capacity	: number of slots, rounded down to a power of two.
+ * 						  Twice the number of handlers keeps the probes short
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int cmd_dispatch__init(struct cmd_dispatch *_disp, struct cmd_dispatch_entry *_table, unsigned int _capacity);
+
+/* ************************************************************************//**
+ * \brief	Register a single handler at init time
+ *
+ * 	Registration must not run concurrently with cmd_dispatch__call().
+ *
+ * \param	_disp		: dispatcher
+ * \param	_cmd		: command to route to the handler
+ * \param	_handler	: handler of the command
+ * \param	_ctx		: context passed to the handler
+ * \return	EOK if successful, -ESTD_EXIST if type and number are already
+ * 			registered, -ELIST_OVERFLOW if the table is full
+ * ****************************************************************************/
+int cmd_dispatch__register(struct cmd_dispatch *_disp, uint32_t _cmd, cmd_dispatch_handler_t _handler, void *_ctx);
+
+/* ************************************************************************//**
+ * \brief	Replace the content of a dispatcher by a table of handlers
+ *
+ * 	Meant for handler tables defined at build time. The hash multiplier
+ * 	is chosen to minimize the number of probes.
+ *
+ * \param	_disp		: initialized dispatcher
+ * \param	_handlers	: handlers to register
+ * \param	_count		: number of handlers
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int cmd_dispatch__build(struct cmd_dispatch *_disp, const struct cmd_dispatch_entry *_handlers, unsigned int _count);
+
+/* ************************************************************************//**
+ * \brief	Route a command to its handler
+ *
+ * \param	_disp		: dispatcher
+ * \param	_cmd		: command to dispatch
+ * \param	_arg		: argument of the command
+ * \param	_arg_size	: size of _arg in bytes
+ * \return	return value of the handler, -EPAR_OPNOTSUPP if no handler is
+ * 			registered or the direction differs, -ECOMM_BADLENGTH if the
+ * 			size of the command or of the argument differs
+ * ****************************************************************************/
+int cmd_dispatch__call(const struct cmd_dispatch *_disp, uint32_t _cmd, void *_arg, size_t _arg_size);
+
+#endif /* LIB_CONVENTION__CMD_DISPATCH_H_ */
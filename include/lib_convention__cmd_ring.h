@@ -0,0 +1,203 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__CMD_RING_H_
+#define LIB_CONVENTION__CMD_RING_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib_convention__mem.h>
+#include <lib_convention__cmd_dispatch.h>
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Submission queue entry
+ *
+ * \param	cmd			: command as created by M_CONV__CMD__CREATE_CMD_*()
+ * \param	arg_size	: size of the payload in bytes
+ * \param	arg			: payload, owned by the submitter until completion
+ * \param	user_data	: passed unchanged to the completion
+ * ****************************************************************************/
+struct cmd_ring_sqe {
+	uint32_t cmd;
+	uint32_t arg_size;
+	void *arg;
+	uint64_t user_data;
+};
+
+/* ************************************************************************//**
+ * \brief	Completion queue entry
+ *
+ * \param	user_data	: user_data of the submission
+ * \param	cmd			: command of the submission
+ * \param	result		: EOK or negative custom error code
+ * ****************************************************************************/
+struct cmd_ring_cqe {
+	uint64_t user_data;
+	uint32_t cmd;
+	int result;
+};
+
+/* ************************************************************************//**
+ * \brief	Submission/completion queue pair
+ *
+ * 	One submitting thread and one driver thread, both queues are single
+ * 	producer / single consumer rings. The indices each side writes are
+ * 	kept on separate cache lines. Submissions are refused while as many
+ * 	commands are in flight as the completion queue holds, so the driver
+ * 	never has to wait for the completion queue.
+ * ****************************************************************************/
+struct cmd_ring {
+	struct cmd_ring_sqe *sq;
+	struct cmd_ring_cqe *cq;
+	uint32_t sq_mask;
+	uint32_t cq_mask;
+	uint8_t pad0[MEM__CACHE_LINE];
+
+	/* submitting thread */
+	uint32_t sq_tail;
+	uint32_t sq_prepared;
+	uint32_t cq_head;
+	uint8_t pad1[MEM__CACHE_LINE];
+
+	/* driver thread */
+	uint32_t sq_head;
+	uint32_t cq_tail;
+	uint32_t cq_prepared;
+	uint8_t pad2[MEM__CACHE_LINE];
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Set up a queue pair over caller supplied entries
+ *
+ * \param	_ring		: queue pair to initialize
+ * \param	_sq			: submission entries
+ * \param	_sq_entries	: number of submission entries, power of two
+ * \param	_cq			: completion entries
+ * \param	_cq_entries	: number of completion entries, power of two,
+ * 						  bounds the number of commands in flight
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int cmd_ring__init(struct cmd_ring *_ring, struct cmd_ring_sqe *_sq, unsigned int _sq_entries,
+				   struct cmd_ring_cqe *_cq, unsigned int _cq_entries);
+
+/* ************************************************************************//**
+ * \brief	Queue a command, invisible to the driver until cmd_ring__submit()
+ *
+ * 	Submitting thread only.
+ *
+ * \param	_ring		: queue pair
+ * \param	_cmd		: command
+ * \param	_arg		: payload reference
+ * \param	_arg_size	: size of the payload in bytes
+ * \param	_user_data	: passed to the completion
+ * \return	EOK if successful, -ESTD_AGAIN if the submission queue is full or
+ * 			completions have to be reaped first
+ * ****************************************************************************/
+int cmd_ring__prep(struct cmd_ring *_ring, uint32_t _cmd, void *_arg, uint32_t _arg_size, uint64_t _user_data);
+
+/* ************************************************************************//**
+ * \brief	Publish all queued commands to the driver at once
+ *
+ * 	Submitting thread only.
+ *
+ * \param	_ring		: queue pair
+ * \return	number of published commands
+ * ****************************************************************************/
+unsigned int cmd_ring__submit(struct cmd_ring *_ring);
+
+/* ************************************************************************//**
+ * \brief	Take completions
+ *
+ * 	Submitting thread only.
+ *
+ * \param	_ring		: queue pair
+ * \param	_cqes		: buffer the completions are passed to
+ * \param	_max		: number of entries of _cqes
+ * \return	number of completions written
+ * ****************************************************************************/
+unsigned int cmd_ring__reap(struct cmd_ring *_ring, struct cmd_ring_cqe *_cqes, unsigned int _max);
+
+/* ************************************************************************//**
+ * \brief	Take submitted commands
+ *
+ * 	Driver thread only. Every taken command has to be completed with
+ * 	cmd_ring__complete().
+ *
+ * \param	_ring		: queue pair
+ * \param	_sqes		: buffer the commands are passed to
+ * \param	_max		: number of entries of _sqes
+ * \return	number of commands written
+ * ****************************************************************************/
+unsigned int cmd_ring__consume(struct cmd_ring *_ring, struct cmd_ring_sqe *_sqes, unsigned int _max);
+
+/* ************************************************************************//**
+ * \brief	Queue the completion of a command, invisible to the submitter
+ * 			until cmd_ring__complete_submit()
+ *
+ * 	Driver thread only.
+ *
+ * \param	_ring		: queue pair
+ * \param	_sqe		: completed command
+ * \param	_result		: EOK or negative custom error code
+ * ****************************************************************************/
+void cmd_ring__complete(struct cmd_ring *_ring, const struct cmd_ring_sqe *_sqe, int _result);
+
+/* ************************************************************************//**
+ * \brief	Publish all queued completions at once
+ *
+ * 	Driver thread only.
+ *
+ * \param	_ring		: queue pair
+ * \return	number of published completions
+ * ****************************************************************************/
+unsigned int cmd_ring__complete_submit(struct cmd_ring *_ring);
+
+/* ************************************************************************//**
+ * \brief	Run a batch of submitted commands through a dispatcher
+ *
+ * 	Driver thread only. Every command is passed to cmd_dispatch__call()
+ * 	in place, its return value is posted as completion. Indices are
+ * 	published once per batch.
+ *
+ * \param	_ring		: queue pair
+ * \param	_disp		: dispatcher the commands are routed through
+ * \param	_max		: maximum number of commands to process
+ * \return	number of processed commands
+ * ****************************************************************************/
+unsigned int cmd_ring__process(struct cmd_ring *_ring, const struct cmd_dispatch *_disp, unsigned int _max);
+
+#endif /* LIB_CONVENTION__CMD_RING_H_ */
@@ -0,0 +1,78 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__CRC_H_
+#define LIB_CONVENTION__CRC_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	CRC-32 (IEEE 802.3, zlib, PNG)
+ *
+ * 	The checksum is computed incrementally, the result of a call is passed
+ * 	as _crc of the call for the following chunk. The kernel is selected on
+ * 	first use: PCLMULQDQ folding, or slicing-by-8 as portable fallback.
+ *
+ * \param	_crc	: 0 for the first chunk, result of the previous call else
+ * \param	_data	: data to checksum
+ * \param	_len	: number of bytes of _data
+ * \return	checksum of all chunks so far
+ * ****************************************************************************/
+uint32_t crc__crc32(uint32_t _crc, const void *_data, size_t _len);
+
+/* ************************************************************************//**
+ * \brief	CRC-32C (Castagnoli, iSCSI, SCTP, ext4)
+ *
+ * 	Incremental like crc__crc32(). Uses the SSE4.2 crc32 instruction if
+ * 	available, PCLMULQDQ folding or slicing-by-8 else.
+ *
+ * \param	_crc	: 0 for the first chunk, result of the previous call else
+ * \param	_data	: data to checksum
+ * \param	_len	: number of bytes of _data
+ * \return	checksum of all chunks so far
+ * ****************************************************************************/
+uint32_t crc__crc32c(uint32_t _crc, const void *_data, size_t _len);
+
+/* ************************************************************************//**
+ * \brief	CRC-16/X-25 (HDLC, PPP FCS)
+ *
+ * 	Incremental like crc__crc32(), PCLMULQDQ folding or slicing-by-8.
+ *
+ * \param	_crc	: 0 for the first chunk, result of the previous call else
+ * \param	_data	: data to checksum
+ * \param	_len	: number of bytes of _data
+ * \return	checksum of all chunks so far
+ * ****************************************************************************/
+uint16_t crc__crc16(uint16_t _crc, const void *_data, size_t _len);
+
+#endif /* LIB_CONVENTION__CRC_H_ */
@@ -30,6 +30,7 @@
  * includes
  * ******************************************************************/
 #include <errno.h>
+#include <stdint.h>
 
 /* *******************************************************************
  * defines
@@ -119,6 +120,72 @@
 #define EHAL_ERROR		1900	/* HAL Error */
 
 #define EOK				0
+
+/* ************************************************************************//**
+ * \brief	Raise a custom error code
+ *
+ * 	Evaluates to _code. If the library is built with LIB_CONVENTION_ERRNO_TRACE
+ * 	the code and the call site are recorded, see lib_convention__errno_trace.h
+ *
+ * 	return ERRNO_RAISE(-ECOMM_TO);
+ * ****************************************************************************/
+#ifdef CONFIG__ERRNO_TRACE
+	#define ERRNO_RAISE(_code)	errno_trace__raise(_code)
+#else
+	#define ERRNO_RAISE(_code)	(_code)
+#endif
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Standard errno value indexed table of the custom codes, 0 marks
+ * 			standard values without mapping
+ * ****************************************************************************/
+extern const uint16_t g_errno_std_map[];
+extern const unsigned int g_errno_std_map_len;
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Convert routine from custom to standard values
+ *
+ * \param	_error_code		Custom code to convert, positive or negative
+ * \return	closest standard errno value with the sign of _error_code, or
+ * 			_error_code itself if it is no custom code
+ * ****************************************************************************/
+int convert_custom_errno(int _error_code);
+
+/* ************************************************************************//**
+ * \brief	Symbolic name of a custom code, e.g. "ECOMM_TO"
+ *
+ * \param	_error_code		Custom code, positive or negative
+ * \return	static string, or NULL if _error_code is no custom code
+ * ****************************************************************************/
+const char* custom_errno_name(int _error_code);
+
+/* ************************************************************************//**
+ * \brief	Description of a custom code in the style of strerror()
+ *
+ * 	Lock-free and allocation-free, the strings are static constants.
+ *
+ * \param	_error_code		Custom code, positive or negative
+ * \return	static string, "Unknown error" if _error_code is no custom code
+ * ****************************************************************************/
+const char* custom_strerror(int _error_code);
+
+#ifdef CONFIG__ERRNO_TRACE
+/* ************************************************************************//**
+ * \brief	Record an error code together with the call site
+ *
+ * \param	_error_code		Error code to record
+ * \return	_error_code
+ * ****************************************************************************/
+int errno_trace__raise(int _error_code);
+#endif
+
 /* *******************************************************************
  * static inline function
  * ******************************************************************/
@@ -132,96 +199,11 @@
  * ****************************************************************************/
 static inline int convert_std_errno(int _error_code)
 {
-    switch (_error_code)
-    {
-        /* "standard" error codes */
-        case EPERM	:	       	return -ESTD_PERM	;
-        case ENOENT	:	       	return -ESTD_NOENT	;
-        case ESRCH	:	       	return -ESTD_SRCH	;
-        case EINTR	:	       	return -ESTD_INTR	;
-        case EIO	:	       	return -ESTD_IO		;
-        case ENXIO	:	       	return -ESTD_NXIO	;
-        case E2BIG	:	       	return -ESTD_2BIG	;
-        case ENOEXEC:	       	return -ESTD_NOEXEC	;
-        case EBADF	:	       	return -ESTD_BADF	;
-        case ECHILD	:	       	return -ESTD_CHILD	;
-        case EAGAIN	:	       	return -ESTD_AGAIN	;
-        case ENOMEM	:	       	return -ESTD_NOMEM	;
-        case EACCES	:	       	return -ESTD_ACCES	;
-        case EFAULT	:	       	return -ESTD_FAULT	;
-        case EBUSY	:	       	return -ESTD_BUSY	;
-        case EEXIST	:	       	return -ESTD_EXIST	;
-        case EXDEV	:	       	return -ESTD_XDEV	;
-        case ENODEV	:	       	return -ESTD_NODEV	;
-        case ENOTDIR:           return -ESTD_NOTDIR	;
-        case EISDIR	:	       	return -ESTD_ISDIR	;
-        case EINVAL	:	       	return -ESTD_INVAL	;
-        case ENFILE	:	       	return -ESTD_NFILE	;
-        case EMFILE	:	       	return -ESTD_MFILE	;
-        case ENOTTY	:	       	return -ESTD_NOTTY	;
-        case EFBIG	:	       	return -ESTD_FBIG	;
-        case ENOSPC	:	       	return -ESTD_NOSPC	;
-        case ESPIPE	:	       	return -ESTD_SPIPE	;
-        case EROFS	:	       	return -ESTD_ROFS	;
-        case EMLINK	:	       	return -ESTD_MLINK	;
-        case EPIPE	:	       	return -ESTD_PIPE	;
-        case EDOM	:	       	return -ESTD_DOM	;
-        case ERANGE	:	       	return -ESTD_RANGE	;
-        case EDEADLK:			return -EEXEC_DEADLK;
-        case ETIMEDOUT: 		return -EEXEC_TO    ;
-
-
-        /* epoll_ctl() */
-        case ELOOP:		       	return -EPAR_COMBI;		// fd refers to an epoll instance and this EPOLL_CTL_ADD operation would result in a circular loop of epoll instances monitoring one another.
-
-        /* socket() */
-        case EAFNOSUPPORT:		return -EPAR_INVCHTYPE;		// The implementation does not support the specified address family.
-        case ENOBUFS:			return -ESTD_NOMEM;		// Insufficient memory is available. The socket cannot be created until sufficient resources are freed.
-        case EPROTONOSUPPORT:	return -EPAR_INVCHN;		// The protocol type or the specified protocol is not supported within this domain.
-
-        /* bind() */
-        case EADDRINUSE:		return -EPAR_OPNOTSUPP;		// The given address is already in use.
-        case ENOTSOCK:			return -EPAR_INVCONFIGTYPE;	// The file descriptor sockfd does not refer to a socket.
-        case EADDRNOTAVAIL:		return -EPAR_INVCONFIG;		// A nonexistent interface was requested or the requested address was not local.
-//	case ELOOP:				return -EPAR_COMBI;			// Too many symbolic links were encountered in resolving addr.
-        case ENAMETOOLONG:		return -EPAR_BADVALUE;		// addr is too long.
-
-        /* sendto() */
-        case ECONNRESET:		return -ECOMM_CONDENIED;	// Connection reset by peer.
-        case EDESTADDRREQ:		return -ECOMM_BADREQ;		// The socket is not connection-mode, and no peer address is set.
-        case EISCONN:			return -ECOMM_ALRDYCON;		// The connection-mode socket was connected already but a recipient was specified. (Now either this error is returned, or the recipient specification is ignored.)
-        case EMSGSIZE:			return -ECOMM_BADLENGTH;	// The socket type requires that message be sent atomically, and the size of the message to be sent made this impossible.
-//	case ENOBUFS:			return -ESTD_NOMEM;			// The output queue for a network interface was full. This generally indicates that the interface has stopped sending, but may be caused by transient congestion. (Normally, this does not occur in Linux. Packets are just silently dropped when a device queue overflows.)
-        case ENOTCONN:			return -ECOMM_NOCON;		// The socket is not connected, and no target has been given.
-//	case ENOTSOCK:			return -EPAR_INVIOTYPE;		// The file descriptor sockfd does not refer to a socket.
-        case EOPNOTSUPP:		return -EEXEC_OPNOTSUPP;	// Some bit in the flags argument is inappropriate for the socket type.
-
-        /* recvmmsg() */
-        case ECONNREFUSED:		return -ECOMM_CONDENIED;	// A remote host refused to allow the network connection (typically because it is not running the requested service).
-//	case ENOTCONN:			return -ECOMM_NOCON;		// The socket is associated with a connection-oriented protocol and has not been connected (see connect(2) and accept(2)).
-//	case ENOTSOCK:			return -EPAR_INVCONFIGTYPE;	// The file descriptor sockfd does not refer to a socket.
-
-        /* write() */
-//	case EDESTADDRREQ:		return -ECOMM_BADREQ;		// The socket is not connection-mode, and no peer address is set.
-        case EDQUOT:			return -EPAR_RANGE;			// The user's quota of disk blocks on the filesystem containing the file referred to by fd has been exhausted.
-
-        /* get-/setsockopt() */
-        case ENOPROTOOPT:		return -EPAR_INVVALUEID;	// The option is unknown at the level indicated.
-//	case ENOTSOCK:			return -EPAR_INVIOTYPE;		// The file descriptor sockfd does not refer to a socket.
-
-        /* open() */
-//	case ELOOP:				return -EPAR_COMBI;			// Too many symbolic links were encountered in resolving pathname.
-//	case ELOOP:				return -EPAR_COMBI;			// pathname was a symbolic link, and flags specified O_NOFOLLOW but not O_PATH.
-//	case EDQUOT:			return -EPAR_RANGE;			// Where O_CREAT is specified, the file does not exist, and the user's quota of disk blocks or inodes on the filesystem has been exhausted.
-//	case ENAMETOOLONG:		return -EPAR_BADVALUE;		// pathname was too long.
-//	case EOPNOTSUPP:		return -EEXEC_OPNOTSUPP;	// The filesystem containing pathname does not support O_TMPFILE.
-        case EOVERFLOW:			return -EPAR_RANGE;			// pathname refers to a regular file that is too large to be opened. The usual scenario here is that an application compiled on a 32-bit platform without -D_FILE_OFFSET_BITS=64 tried to open a file whose size exceeds (1<<31)-1 bytes; see also O_LARGEFILE above. This is the error specified by POSIX.1; in kernels before 2.6.24, Linux gave the error EFBIG for this case.
-        case ETXTBSY:			return -EPERM_RO;			// pathname refers to an executable image which is currently being executed and write access was requested.
-
-
-        /* unknown / unexpected error */
-        default:			return -errno;				// return negative errno to indicate missing mapping
-    }
+	if (((unsigned int)_error_code < g_errno_std_map_len) && (g_errno_std_map[_error_code] != 0)) {
+		return ERRNO_RAISE(-(int)g_errno_std_map[_error_code]);
+	}
+	/* return negative errno to indicate missing mapping */
+	return ERRNO_RAISE(-_error_code);
 }
 
 
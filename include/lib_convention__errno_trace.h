@@ -0,0 +1,102 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__ERRNO_TRACE_H_
+#define LIB_CONVENTION__ERRNO_TRACE_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+
+#include <lib_convention__errno.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Number of events each thread buffers until they are drained,
+ * 			has to be a power of two
+ * ****************************************************************************/
+#define ERRNO_TRACE__RING_SIZE		256U
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Recorded error
+ *
+ * \param	code		: error code as raised or converted
+ * \param	thread		: id of the recording thread (order of first record)
+ * \param	site		: code address of the raise or conversion
+ * \param	timestamp	: monotonic time in nanoseconds
+ * ****************************************************************************/
+struct errno_trace_event {
+	int code;
+	uint32_t thread;
+	void *site;
+	uint64_t timestamp;
+};
+
+/* ************************************************************************//**
+ * \brief	Number of occurrences of an error code
+ *
+ * 	Codes which are no custom codes are accumulated under code 0.
+ * ****************************************************************************/
+struct errno_trace_count {
+	int code;
+	uint64_t count;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Sum up the per-code counters of all threads
+ *
+ * 	The recording threads are never blocked by this call.
+ *
+ * \param	_counts		: codes with a non zero count are passed to this array
+ * \param	_max		: number of entries of _counts
+ * \param	_dropped	: number of events lost on full rings, may be NULL
+ * \return	number of entries written, or negative errno value on error
+ * ****************************************************************************/
+int errno_trace__counters(struct errno_trace_count *_counts, unsigned int _max, uint64_t *_dropped);
+
+/* ************************************************************************//**
+ * \brief	Move recorded events out of the per-thread rings
+ *
+ * 	Has to be called from a single monitoring thread at a time.
+ *
+ * \param	_events		: drained events are passed to this array
+ * \param	_max		: number of entries of _events
+ * \return	number of events written, or negative errno value on error
+ * ****************************************************************************/
+int errno_trace__drain(struct errno_trace_event *_events, unsigned int _max);
+
+#endif /* LIB_CONVENTION__ERRNO_TRACE_H_ */
@@ -0,0 +1,206 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef LIB_CONVENTION__HEAP_H_
+#define LIB_CONVENTION__HEAP_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Alignment of the blocks of the private backends
+ *
+ * 	Blocks of HEAP__BACKEND_SYSTEM have the alignment of alloc_memory().
+ * ****************************************************************************/
+#define HEAP__ALIGN					16U
+
+/* ************************************************************************//**
+ * \brief	Chunk size used if 0 is passed in struct heap_config
+ * ****************************************************************************/
+#define HEAP__DEFAULT_CHUNK_SIZE	(64U * 1024U)
+
+/* ************************************************************************//**
+ * \brief	Largest block served from the size classes of
+ * 			HEAP__BACKEND_SEGREGATED, bigger blocks get a chunk of their own
+ * ****************************************************************************/
+#define HEAP__SEGREGATED_MAX		4096U
+
+/* ************************************************************************//**
+ * \brief	Flags of struct heap_config
+ *
+ * 	HEAP__FLAG_SHARED	: the heap is used by several threads, every
+ * 						  operation is serialized. Without the flag the heap
+ * 						  belongs to a single thread and takes no lock.
+ * ****************************************************************************/
+#define HEAP__FLAG_NONE				0x0U
+#define HEAP__FLAG_SHARED			0x1U
+
+/* ************************************************************************//**
+ * \brief	Preferred memory node if no NUMA placement is requested
+ * ****************************************************************************/
+#define HEAP__NODE_ANY				(-1)
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+struct heap;
+
+/* ************************************************************************//**
+ * \brief	Allocation strategy of a heap
+ *
+ * 	HEAP__BACKEND_SYSTEM	: blocks come from alloc_memory() and are tracked,
+ * 							  so destroying the heap releases the leftovers
+ * 	HEAP__BACKEND_ARENA		: bump allocation from private chunks, heap__free()
+ * 							  is a no-op and memory is returned by heap__reset()
+ * 							  or heap__destroy()
+ * 	HEAP__BACKEND_SEGREGATED: power of two size classes with free lists over
+ * 							  private chunks, freed memory is only reused by
+ * 							  the same heap
+ * 	HEAP__BACKEND_POOL		: fixed size blocks in a single region reserved at
+ * 							  creation, allocation never touches the system
+ * ****************************************************************************/
+enum heap_backend {
+	HEAP__BACKEND_SYSTEM = 0,
+	HEAP__BACKEND_ARENA,
+	HEAP__BACKEND_SEGREGATED,
+	HEAP__BACKEND_POOL
+};
+
+/* ************************************************************************//**
+ * \brief	Parameters of heap__create()
+ *
+ * \param	backend		: allocation strategy
+ * \param	flags		: HEAP__FLAG_NONE or HEAP__FLAG_SHARED
+ * \param	chunk_size	: size of the chunks taken from the system by the
+ * 						  ARENA and SEGREGATED backends, 0 selects
+ * 						  HEAP__DEFAULT_CHUNK_SIZE
+ * \param	block_size	: largest request of the POOL backend
+ * \param	blocks		: number of blocks of the POOL backend
+ * \param	node		: NUMA node the private chunks are placed on, or
+ * 						  HEAP__NODE_ANY. Ignored by the SYSTEM backend and on
+ * 						  targets without NUMA support.
+ * \param	name		: name reported by heap__name(), not copied
+ * ****************************************************************************/
+struct heap_config {
+	enum heap_backend backend;
+	unsigned int flags;
+	size_t chunk_size;
+	size_t block_size;
+	unsigned int blocks;
+	int node;
+	const char *name;
+};
+
+/* ************************************************************************//**
+ * \brief	Counters of a heap
+ *
+ * \param	reserved_bytes	: memory the heap holds from the system
+ * \param	live_blocks		: blocks handed out and not released yet
+ * ****************************************************************************/
+struct heap_stats {
+	size_t reserved_bytes;
+	size_t live_blocks;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Create a heap for the exclusive use of one subsystem
+ *
+ * 	Memory of a heap is never shared with other heaps, so fragmentation
+ * 	stays local and all of it can be dropped at once by heap__destroy().
+ *
+ * \param	_heap		: created heap is passed to this pointer
+ * \param	_config		: backend and parameters of the heap
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int heap__create(struct heap **_heap, const struct heap_config *_config);
+
+/* ************************************************************************//**
+ * \brief	Release a heap together with every block still allocated from it
+ *
+ * \param	_heap		: heap to destroy, set to NULL afterwards
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int heap__destroy(struct heap **_heap);
+
+/* ************************************************************************//**
+ * \brief	Release every block allocated from a heap
+ *
+ * 	Private chunks and the pool region are kept for reuse, tracked blocks of
+ * 	the SYSTEM backend are returned to alloc_memory().
+ *
+ * \param	_heap		: heap to reset
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int heap__reset(struct heap *_heap);
+
+/* ************************************************************************//**
+ * \brief	Allocate zero initialized memory from a heap
+ *
+ * \param	_heap		: heap to allocate from, NULL selects the default heap
+ * 						  which is alloc_memory()
+ * \param	_size		: requested number of bytes
+ * \return	pointer to the memory, or NULL if out of memory
+ * ****************************************************************************/
+void* heap__alloc(struct heap *_heap, size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Return memory to the heap it was allocated from
+ *
+ * \param	_heap		: heap passed to heap__alloc(), NULL for the default
+ * 						  heap which is free_memory()
+ * \param	_mem		: memory to release, NULL is ignored
+ * ****************************************************************************/
+void heap__free(struct heap *_heap, void *_mem);
+
+/* ************************************************************************//**
+ * \brief	Read the counters of a heap
+ *
+ * \param	_heap		: heap to investigate
+ * \param	_stats		: counters are passed to this structure
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int heap__stats(const struct heap *_heap, struct heap_stats *_stats);
+
+/* ************************************************************************//**
+ * \brief	Name of a heap as given in struct heap_config
+ *
+ * \param	_heap		: heap to investigate, NULL for the default heap
+ * \return	name of the heap, never NULL
+ * ****************************************************************************/
+const char* heap__name(const struct heap *_heap);
+
+#endif /* LIB_CONVENTION__HEAP_H_ */
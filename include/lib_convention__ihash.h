@@ -0,0 +1,167 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__IHASH_H_
+#define LIB_CONVENTION__IHASH_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib_convention__macro.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Object which embeds the node
+ * ****************************************************************************/
+#define IHASH__ENTRY(_node, _type, _member)		((_type*)GET_CONTAINER_OF(_node, _type, _member))
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Hook embedded into the objects of a hash table
+ * ****************************************************************************/
+struct ihash_node {
+	uint32_t hash;
+};
+
+/* ************************************************************************//**
+ * \brief	Slot of the table, the hash is kept next to the node pointer so
+ * 			probing does not touch the objects
+ * ****************************************************************************/
+struct ihash_slot {
+	uint32_t hash;
+	struct ihash_node *node;
+};
+
+/* ************************************************************************//**
+ * \brief	Key comparison
+ *
+ * \param	_node	: node of the table
+ * \param	_key	: key passed to ihash__find() or ihash__insert()
+ * \return	non-zero if the node has the key
+ * ****************************************************************************/
+typedef int (*ihash_equal_t)(const struct ihash_node *_node, const void *_key);
+
+/* ************************************************************************//**
+ * \brief	Intrusive open-addressing hash table over caller supplied slots
+ *
+ * 	Linear probing, removal shifts the following entries back, so no
+ * 	tombstones are left and lookups stay short.
+ * ****************************************************************************/
+struct ihash {
+	struct ihash_slot *slots;
+	uint32_t mask;
+	uint32_t count;
+	ihash_equal_t equal;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Set up an empty table
+ *
+ * \param	_table		: table to initialize
+ * \param	_slots		: slots of the table
+ * \param	_capacity	: number of slots, power of two. One slot always
+ * 						  stays free, a load below 3/4 keeps probes short
+ * \param	_equal		: key comparison
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int ihash__init(struct ihash *_table, struct ihash_slot *_slots, unsigned int _capacity, ihash_equal_t _equal);
+
+/* ************************************************************************//**
+ * \brief	Insert a node
+ *
+ * \param	_table		: table
+ * \param	_node		: node to insert
+ * \param	_hash		: hash of the key of the node
+ * \param	_key		: key of the node, checked for duplicates
+ * \return	EOK if successful, -ESTD_EXIST if the key is already stored,
+ * 			-ELIST_OVERFLOW if the table is full
+ * ****************************************************************************/
+int ihash__insert(struct ihash *_table, struct ihash_node *_node, uint32_t _hash, const void *_key);
+
+/* ************************************************************************//**
+ * \brief	Look up a key
+ *
+ * \param	_table		: table
+ * \param	_hash		: hash of the key
+ * \param	_key		: key passed to the comparison
+ * \return	the node, or NULL if the key is not stored
+ * ****************************************************************************/
+struct ihash_node* ihash__find(const struct ihash *_table, uint32_t _hash, const void *_key);
+
+/* ************************************************************************//**
+ * \brief	Remove a node
+ *
+ * \param	_table		: table
+ * \param	_node		: node to remove
+ * \return	EOK if successful, -ESTD_NOENT if the node is not stored
+ * ****************************************************************************/
+int ihash__remove(struct ihash *_table, struct ihash_node *_node);
+
+/* *******************************************************************
+ * static inline function
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Hash an integer key (finalizer of MurmurHash3)
+ * ****************************************************************************/
+static inline uint32_t ihash__hash_u64(uint64_t _key)
+{
+	_key ^= _key >> 33;
+	_key *= 0xFF51AFD7ED558CCDULL;
+	_key ^= _key >> 33;
+	_key *= 0xC4CEB9FE1A85EC53ULL;
+	_key ^= _key >> 33;
+	return (uint32_t)_key;
+}
+
+/* ************************************************************************//**
+ * \brief	Hash a byte string (FNV-1a)
+ * ****************************************************************************/
+static inline uint32_t ihash__hash_bytes(const void *_data, size_t _len)
+{
+	const uint8_t *data = (const uint8_t*)_data;
+	uint32_t hash = 0x811C9DC5U;
+	size_t i;
+
+	for (i = 0; i < _len; i++) {
+		hash = (hash ^ data[i]) * 0x01000193U;
+	}
+	return hash;
+}
+
+#endif /* LIB_CONVENTION__IHASH_H_ */
@@ -0,0 +1,188 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__ILIST_H_
+#define LIB_CONVENTION__ILIST_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stddef.h>
+
+#include <lib_convention__macro.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Object which embeds the node
+ *
+ * \parm  _node	:   pointer to the embedded struct ilist_node
+ * \parm  _type	:   type of the object
+ * \parm  _member:  name of the node within the object
+ * ****************************************************************************/
+#define ILIST__ENTRY(_node, _type, _member)		((_type*)GET_CONTAINER_OF(_node, _type, _member))
+
+/* ************************************************************************//**
+ * \brief	Iterate over all nodes, _node must not be removed within the loop
+ * ****************************************************************************/
+#define ILIST__FOREACH(_list, _node)	\
+			for ((_node) = (_list)->head.next; (_node) != &(_list)->head; (_node) = (_node)->next)
+
+/* ************************************************************************//**
+ * \brief	Iterate over all nodes, _node may be removed within the loop
+ * ****************************************************************************/
+#define ILIST__FOREACH_SAFE(_list, _node, _tmp)	\
+			for ((_node) = (_list)->head.next, (_tmp) = (_node)->next; (_node) != &(_list)->head; \
+				 (_node) = (_tmp), (_tmp) = (_node)->next)
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Hook embedded into the objects of a list
+ * ****************************************************************************/
+struct ilist_node {
+	struct ilist_node *next;
+	struct ilist_node *prev;
+};
+
+/* ************************************************************************//**
+ * \brief	Intrusive circular doubly-linked list
+ *
+ * 	The list never allocates, the objects embed a struct ilist_node.
+ * 	The head is a sentinel, so insert and remove need no branches.
+ * ****************************************************************************/
+struct ilist {
+	struct ilist_node head;
+};
+
+/* *******************************************************************
+ * static inline function
+ * ******************************************************************/
+
+static inline void ilist__init(struct ilist *_list)
+{
+	_list->head.next = &_list->head;
+	_list->head.prev = &_list->head;
+}
+
+static inline int ilist__empty(const struct ilist *_list)
+{
+	return _list->head.next == &_list->head;
+}
+
+/* ************************************************************************//**
+ * \brief	Insert _node behind _pos, _pos may be the head of the list
+ * ****************************************************************************/
+static inline void ilist__insert_after(struct ilist_node *_pos, struct ilist_node *_node)
+{
+	_node->prev = _pos;
+	_node->next = _pos->next;
+	_pos->next->prev = _node;
+	_pos->next = _node;
+}
+
+/* ************************************************************************//**
+ * \brief	Insert _node in front of _pos, _pos may be the head of the list
+ * ****************************************************************************/
+static inline void ilist__insert_before(struct ilist_node *_pos, struct ilist_node *_node)
+{
+	ilist__insert_after(_pos->prev, _node);
+}
+
+static inline void ilist__push_front(struct ilist *_list, struct ilist_node *_node)
+{
+	ilist__insert_after(&_list->head, _node);
+}
+
+static inline void ilist__push_back(struct ilist *_list, struct ilist_node *_node)
+{
+	ilist__insert_after(_list->head.prev, _node);
+}
+
+/* ************************************************************************//**
+ * \brief	Unlink a node from the list it is linked into
+ * ****************************************************************************/
+static inline void ilist__remove(struct ilist_node *_node)
+{
+	_node->prev->next = _node->next;
+	_node->next->prev = _node->prev;
+	_node->next = _node;
+	_node->prev = _node;
+}
+
+/* ************************************************************************//**
+ * \brief	First or last node of the list
+ * \return	the node, or NULL if the list is empty
+ * ****************************************************************************/
+static inline struct ilist_node* ilist__first(const struct ilist *_list)
+{
+	return ilist__empty(_list) ? NULL : _list->head.next;
+}
+
+static inline struct ilist_node* ilist__last(const struct ilist *_list)
+{
+	return ilist__empty(_list) ? NULL : _list->head.prev;
+}
+
+static inline struct ilist_node* ilist__pop_front(struct ilist *_list)
+{
+	struct ilist_node *node = ilist__first(_list);
+
+	if (node != NULL) {
+		ilist__remove(node);
+	}
+	return node;
+}
+
+static inline struct ilist_node* ilist__pop_back(struct ilist *_list)
+{
+	struct ilist_node *node = ilist__last(_list);
+
+	if (node != NULL) {
+		ilist__remove(node);
+	}
+	return node;
+}
+
+/* ************************************************************************//**
+ * \brief	Move all nodes of _from to the end of _to in constant time
+ * ****************************************************************************/
+static inline void ilist__splice(struct ilist *_to, struct ilist *_from)
+{
+	if (ilist__empty(_from)) {
+		return;
+	}
+	_from->head.next->prev = _to->head.prev;
+	_to->head.prev->next = _from->head.next;
+	_from->head.prev->next = &_to->head;
+	_to->head.prev = _from->head.prev;
+	ilist__init(_from);
+}
+
+#endif /* LIB_CONVENTION__ILIST_H_ */
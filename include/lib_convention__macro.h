@@ -58,9 +58,30 @@
  *
  * 	(_size + _boundary_mask) & ~(_boundary_mask) 	7 + 3 = 10 (1010) & (1100) =  1000 -> 8
  *
+ * 	The mask takes the type of _size, an unsigned int boundary would
+ * 	otherwise clear the upper half of a 64 bit size.
+ *
+ * * ****************************************************************************/
+#define ALIGN(_size, _boundary)     		__ALIGN_MASK((_size), ((__typeof__(_size))(_boundary) - 1))
+#define __ALIGN_MASK(_size,_boundary_mask)  (((_size) + (_boundary_mask)) & ~(_boundary_mask))
+
+/* ************************************************************************//**
+ * \brief  Round up to the next power of 2
+ *
+ * \parm  _size		: value in the range of 1 to 2^31
+ *
+ * 	All bits below the highest set bit of (_size - 1) are set, adding one
+ * 	carries into the next power of two. The result is a constant expression,
+ * 	so it can size static buffers.
+ *
+ * 	_size	= 5 -> 4 (0100) -> 7 (0111) + 1 -> 8
  * * ****************************************************************************/
-#define ALIGN(_size, _boundary)     		__ALIGN_MASK(_size, _boundary-1)
-#define __ALIGN_MASK(_size,_boundary_mask)  ((_size + _boundary_mask)&~(_boundary_mask))
+#define ALIGN_POW2(_size)					(__POW2_SMEAR16((uint32_t)(_size) - 1U) + 1U)
+#define __POW2_SMEAR1(_x)					((_x) | ((_x) >> 1))
+#define __POW2_SMEAR2(_x)					(__POW2_SMEAR1(_x) | (__POW2_SMEAR1(_x) >> 2))
+#define __POW2_SMEAR4(_x)					(__POW2_SMEAR2(_x) | (__POW2_SMEAR2(_x) >> 4))
+#define __POW2_SMEAR8(_x)					(__POW2_SMEAR4(_x) | (__POW2_SMEAR4(_x) >> 8))
+#define __POW2_SMEAR16(_x)					(__POW2_SMEAR8(_x) | (__POW2_SMEAR8(_x) >> 16))
 
 
 /* ************************************************************************//**
@@ -123,20 +144,140 @@
 /* ************************************************************************//**
  * \brief Bit Position form the first bit that is found
  *
- *	!!!!! Attention it have to be SECURED that "_val > 0" is ensured
+ *	If no bit is set at or above _startbit, _ret is set to a value above 31.
  * \parm  _val		:   register to investigate for active bit
  * \parm  _startbit	:   bit number to start investigation
  * \parm  _ret		:   the found bit number is stored at passed to _ret
  * * ****************************************************************************/
 #define BIT_POS(_val, _startbit, _ret){		\
-		uint32_t bit_pos__value = _val >> _startbit;        \
-		_ret = _startbit;										\
-		while ((bit_pos__value & 0x1) == 0) 	{				\
-			_ret++;												\
-			bit_pos__value = (bit_pos__value >> 1);				\
-		}														\
+		_ret = (_startbit) + bit__ctz32((uint32_t)(_val) >> (_startbit));	\
 }
 
+/* *******************************************************************
+ * static inline function
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief  Count trailing zero bits
+ *
+ *	Maps to a single instruction (tzcnt/bsf, rbit+clz) with GCC and clang,
+ *	other compilers use a portable fallback.
+ *
+ * \parm  _val	:   value to investigate
+ * \return  number of zero bits below the lowest set bit, 32 or 64 for zero
+ * * ****************************************************************************/
+static inline unsigned int bit__ctz32(uint32_t _val)
+{
+#if defined(__GNUC__)
+	return (_val != 0) ? (unsigned int)__builtin_ctzl((unsigned long)_val) : 32U;
+#else
+	static const uint8_t debruijn[32] = {
+		0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+		31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+	};
+	return (_val != 0) ? debruijn[(uint32_t)((_val & (0U - _val)) * 0x077CB531U) >> 27] : 32U;
+#endif
+}
+
+static inline unsigned int bit__ctz64(uint64_t _val)
+{
+#if defined(__GNUC__)
+	return (_val != 0) ? (unsigned int)__builtin_ctzll((unsigned long long)_val) : 64U;
+#else
+	return ((uint32_t)_val != 0) ? bit__ctz32((uint32_t)_val) : 32U + bit__ctz32((uint32_t)(_val >> 32));
+#endif
+}
+
+/* ************************************************************************//**
+ * \brief  Count leading zero bits
+ *
+ * \parm  _val	:   value to investigate
+ * \return  number of zero bits above the highest set bit, 32 or 64 for zero
+ * * ****************************************************************************/
+static inline unsigned int bit__clz32(uint32_t _val)
+{
+#if defined(__GNUC__)
+	return (_val != 0) ? (unsigned int)__builtin_clzll((unsigned long long)_val) - 32U : 32U;
+#else
+	unsigned int n = 0;
+
+	if (_val == 0) {
+		return 32U;
+	}
+	if ((_val & 0xFFFF0000U) == 0) { n += 16U; _val <<= 16; }
+	if ((_val & 0xFF000000U) == 0) { n += 8U; _val <<= 8; }
+	if ((_val & 0xF0000000U) == 0) { n += 4U; _val <<= 4; }
+	if ((_val & 0xC0000000U) == 0) { n += 2U; _val <<= 2; }
+	if ((_val & 0x80000000U) == 0) { n += 1U; }
+	return n;
+#endif
+}
 
+static inline unsigned int bit__clz64(uint64_t _val)
+{
+#if defined(__GNUC__)
+	return (_val != 0) ? (unsigned int)__builtin_clzll((unsigned long long)_val) : 64U;
+#else
+	return ((_val >> 32) != 0) ? bit__clz32((uint32_t)(_val >> 32)) : 32U + bit__clz32((uint32_t)_val);
+#endif
+}
+
+/* ************************************************************************//**
+ * \brief  Find the lowest set bit (find-first-set)
+ *
+ * \parm  _val	:   value to investigate
+ * \return  bit number of the lowest set bit, or -1 for zero
+ * * ****************************************************************************/
+static inline int bit__ffs32(uint32_t _val)
+{
+	return (_val != 0) ? (int)bit__ctz32(_val) : -1;
+}
+
+static inline int bit__ffs64(uint64_t _val)
+{
+	return (_val != 0) ? (int)bit__ctz64(_val) : -1;
+}
+
+/* ************************************************************************//**
+ * \brief  Find the highest set bit (find-last-set)
+ *
+ * \parm  _val	:   value to investigate
+ * \return  bit number of the highest set bit, or -1 for zero
+ * * ****************************************************************************/
+static inline int bit__fls32(uint32_t _val)
+{
+	return 31 - (int)bit__clz32(_val);
+}
+
+static inline int bit__fls64(uint64_t _val)
+{
+	return 63 - (int)bit__clz64(_val);
+}
+
+/* ************************************************************************//**
+ * \brief  Count the set bits (population count)
+ *
+ * \parm  _val	:   value to investigate
+ * \return  number of set bits
+ * * ****************************************************************************/
+static inline unsigned int bit__popcount32(uint32_t _val)
+{
+#if defined(__GNUC__)
+	return (unsigned int)__builtin_popcountl((unsigned long)_val);
+#else
+	_val = _val - ((_val >> 1) & 0x55555555U);
+	_val = (_val & 0x33333333U) + ((_val >> 2) & 0x33333333U);
+	return (((_val + (_val >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24;
+#endif
+}
+
+static inline unsigned int bit__popcount64(uint64_t _val)
+{
+#if defined(__GNUC__)
+	return (unsigned int)__builtin_popcountll((unsigned long long)_val);
+#else
+	return bit__popcount32((uint32_t)_val) + bit__popcount32((uint32_t)(_val >> 32));
+#endif
+}
 
 #endif /* LIB_CONVENTION__MACRO_H_ */
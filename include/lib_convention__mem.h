@@ -31,6 +31,15 @@
  * ******************************************************************/
 #include <stddef.h>
 
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Cache line size used to separate data of different cores
+ * ****************************************************************************/
+#define MEM__CACHE_LINE		64U
+
 /* *******************************************************************
  * function declarations
  * ******************************************************************/
@@ -38,4 +47,112 @@ void* alloc_memory(unsigned int _count, size_t _size);
 
 void free_memory(void* _mem);
 
+/* ************************************************************************//**
+ * \brief	Allocate memory without initializing it
+ *
+ * 	For buffers which are completely overwritten by the caller anyway.
+ *
+ * \param	_mem	: allocated memory is passed to this pointer
+ * \param	_count	: number of elements
+ * \param	_size	: size of an element
+ * \return	EOK if successful, -EPAR_NULL, -EPAR_RANGE if _count * _size
+ * 			overflows, or -ESTD_NOMEM if out of memory
+ * ****************************************************************************/
+int alloc_memory_uninit(void **_mem, unsigned int _count, size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Allocate zero initialized memory with overflow checked sizing
+ *
+ * \param	_mem	: allocated memory is passed to this pointer
+ * \param	_count	: number of elements
+ * \param	_size	: size of an element
+ * \return	EOK if successful, -EPAR_NULL, -EPAR_RANGE if _count * _size
+ * 			overflows, or -ESTD_NOMEM if out of memory
+ * ****************************************************************************/
+int alloc_memory_checked(void **_mem, unsigned int _count, size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Resize memory allocated by alloc_memory(), alloc_memory_uninit(),
+ * 			alloc_memory_checked() or realloc_memory()
+ *
+ * 	The content up to the smaller of both sizes is preserved, bytes beyond
+ * 	the old size are not initialized. On error the old memory is kept.
+ *
+ * \param	_mem		: memory to resize (may point to NULL), the resized
+ * 						  memory is passed to this pointer
+ * \param	_old_size	: size requested for the memory before, required by
+ * 						  backends which cannot look it up
+ * \param	_size		: requested number of bytes
+ * \return	EOK if successful, -EPAR_NULL or -ESTD_NOMEM if out of memory
+ * ****************************************************************************/
+int realloc_memory(void **_mem, size_t _old_size, size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Release memory whose size is known by the caller
+ *
+ * 	Saves the size lookup of free_memory(). Only valid for memory of
+ * 	alloc_memory(), alloc_memory_uninit(), alloc_memory_checked() and
+ * 	realloc_memory().
+ *
+ * \param	_mem	: memory to release, NULL is ignored
+ * \param	_size	: total size requested at the allocation or last resize
+ * ****************************************************************************/
+void free_memory_sized(void* _mem, size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Allocate an array of equally sized zero initialized objects
+ *
+ * 	Allocator locks and cache refills are paid once per call and not once
+ * 	per object. Either all or no objects are allocated.
+ *
+ * \param	_mem	: array the allocated objects are passed to
+ * \param	_count	: number of objects
+ * \param	_size	: size of a single object
+ * \return	EOK if successful, -EPAR_NULL or -ESTD_NOMEM if out of memory
+ * ****************************************************************************/
+int alloc_memory_bulk(void **_mem, unsigned int _count, size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Release an array of objects allocated by alloc_memory() or
+ * 			alloc_memory_bulk()
+ *
+ * \param	_mem	: objects to release, NULL entries are ignored
+ * \param	_count	: number of entries of _mem
+ * ****************************************************************************/
+void free_memory_bulk(void **_mem, unsigned int _count);
+
+/* ************************************************************************//**
+ * \brief	Allocate zero initialized memory with a specific alignment
+ *
+ * \param	_count	: number of elements
+ * \param	_size	: size of an element
+ * \param	_align	: power of two alignment, e.g. MEM__CACHE_LINE
+ * \return	pointer to the memory, or NULL if out of memory or invalid arguments
+ * ****************************************************************************/
+void* alloc_memory_aligned(unsigned int _count, size_t _size, size_t _align);
+
+/* ************************************************************************//**
+ * \brief	Release memory allocated by alloc_memory_aligned()
+ * ****************************************************************************/
+void free_memory_aligned(void* _mem);
+
+/* ************************************************************************//**
+ * \brief	Allocate a large zero initialized buffer
+ *
+ * 	On unix the buffer is a dedicated page aligned mapping, advised for
+ * 	transparent huge pages when at least 2 MiB are requested. Mappings of
+ * 	released buffers are retained and reused, such a buffer is cleared
+ * 	with memset unless its pages were returned to the kernel before. Fresh
+ * 	mappings are zero filled by the kernel without a memset.
+ *
+ * \param	_size	: requested number of bytes
+ * \return	pointer to the memory, or NULL if out of memory
+ * ****************************************************************************/
+void* alloc_memory_large(size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Release memory allocated by alloc_memory_large()
+ * ****************************************************************************/
+void free_memory_large(void* _mem);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__MEM_PURGE_H_
+#define LIB_CONVENTION__MEM_PURGE_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Retention of free memory by the unix backend
+ *
+ * 	Freed memory is kept resident for reuse. Memory which stayed unused for
+ * 	one to two decay periods is purged, its pages are returned to the
+ * 	system while the address range is kept. Released large mappings are
+ * 	unmapped after another period.
+ *
+ * \param	decay_ms	: decay period, 0 returns freed memory immediately
+ * \param	ceiling		: retained bytes above which all freed memory is
+ * 						  purged regardless of its age, SIZE_MAX for none
+ * \param	lazy		: purge with MADV_FREE, the kernel reclaims the pages
+ * 						  under memory pressure only, which avoids the page
+ * 						  faults if they are reused before
+ * ****************************************************************************/
+struct mem_purge_config {
+	unsigned int decay_ms;
+	size_t ceiling;
+	int lazy;
+};
+
+/* ************************************************************************//**
+ * \brief	Purge statistics
+ *
+ * \param	retained_bytes	: freed bytes which are still resident and could
+ * 							  be returned by a purge
+ * \param	purged_bytes	: bytes advised to the system so far
+ * \param	unmapped_bytes	: bytes of released mappings unmapped so far
+ * \param	runs			: number of purge runs
+ * ****************************************************************************/
+struct mem_purge_stats {
+	uint64_t retained_bytes;
+	uint64_t purged_bytes;
+	uint64_t unmapped_bytes;
+	uint64_t runs;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Configure the retention of free memory
+ *
+ * 	Defaults are a decay period of 10 s, no ceiling and MADV_DONTNEED.
+ *
+ * \param	_config	: new configuration
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_purge__configure(const struct mem_purge_config *_config);
+
+/* ************************************************************************//**
+ * \brief	Run a decay step now
+ *
+ * 	Decay steps are also run from the release paths once the period is
+ * 	due, this is for processes which go idle without freeing.
+ *
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_purge__run(void);
+
+/* ************************************************************************//**
+ * \brief	Return all free memory the library and the C library can give
+ * 			back, e.g. after a traffic spike
+ *
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_purge__trim(void);
+
+/* ************************************************************************//**
+ * \brief	Start a background thread which runs the decay steps
+ *
+ * \return	EOK if successful, -ESTD_EXIST if already running, or negative
+ * 			errno value on error
+ * ****************************************************************************/
+int mem_purge__start(void);
+
+/* ************************************************************************//**
+ * \brief	Stop the background thread
+ *
+ * \return	EOK if successful, -ESTD_NOENT if not running
+ * ****************************************************************************/
+int mem_purge__stop(void);
+
+/* ************************************************************************//**
+ * \brief	Read the purge statistics
+ *
+ * \param	_stats	: the statistics are passed to this pointer
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_purge__stats(struct mem_purge_stats *_stats);
+
+#endif /* LIB_CONVENTION__MEM_PURGE_H_ */
@@ -0,0 +1,123 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__MEM_STATS_H_
+#define LIB_CONVENTION__MEM_STATS_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Number of buckets of the size histogram
+ *
+ * 	Bucket n counts allocations with a usable size in [2^(n-1), 2^n),
+ * 	the last bucket collects everything above.
+ * ****************************************************************************/
+#define MEM_STATS__HIST_BUCKETS		32U
+
+/* ************************************************************************//**
+ * \brief	Number of call-site samples retained until they are read
+ * ****************************************************************************/
+#define MEM_STATS__SAMPLE_SLOTS		1024U
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Process wide allocation statistics
+ *
+ * \param	alloc_calls		: number of successful allocations
+ * \param	free_calls		: number of releases
+ * \param	alloc_bytes		: usable bytes handed out
+ * \param	free_bytes		: usable bytes released
+ * \param	live_objects	: allocations not released yet
+ * \param	live_bytes		: usable bytes not released yet
+ * \param	histogram		: allocations per size bucket
+ * ****************************************************************************/
+struct mem_stats_snapshot {
+	uint64_t alloc_calls;
+	uint64_t free_calls;
+	uint64_t alloc_bytes;
+	uint64_t free_bytes;
+	uint64_t live_objects;
+	uint64_t live_bytes;
+	uint64_t histogram[MEM_STATS__HIST_BUCKETS];
+};
+
+/* ************************************************************************//**
+ * \brief	Sampled allocation
+ *
+ * \param	caller	: return address of the alloc_memory*() call
+ * \param	size	: usable size of the sampled allocation
+ * \param	weight	: number of allocated bytes the sample stands for
+ * ****************************************************************************/
+struct mem_stats_sample {
+	void *caller;
+	size_t size;
+	uint64_t weight;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Merge the per-thread counters into a snapshot
+ *
+ * 	Counters are only collected if the library is built with
+ * 	LIB_CONVENTION_MEM_STATS.
+ *
+ * \param	_snap	: the statistics are passed to this snapshot
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_stats__snapshot(struct mem_stats_snapshot *_snap);
+
+/* ************************************************************************//**
+ * \brief	Configure call-site sampling
+ *
+ * \param	_bytes	: mean number of allocated bytes between two samples,
+ * 					  0 disables sampling (default)
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_stats__set_sample_interval(size_t _bytes);
+
+/* ************************************************************************//**
+ * \brief	Drain the oldest call-site samples
+ *
+ * \param	_samples	: buffer the samples are passed to
+ * \param	_max		: number of entries of _samples
+ * \return	number of samples written, or negative errno value on error
+ * ****************************************************************************/
+int mem_stats__read_samples(struct mem_stats_sample *_samples, unsigned int _max);
+
+#endif /* LIB_CONVENTION__MEM_STATS_H_ */
@@ -0,0 +1,289 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__MEMORY_RESOURCE_HPP_
+#define LIB_CONVENTION__MEMORY_RESOURCE_HPP_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory_resource>
+
+/* own libs */
+extern "C" {
+#include <lib_convention__macro.h>
+#include <lib_convention__mem.h>
+#include <lib_convention__arena.h>
+}
+
+#if (__cplusplus < 201703L)
+	#error "lib_convention__memory_resource.hpp requires C++17"
+#endif
+
+namespace lib_convention {
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	std::pmr::memory_resource on alloc_memory()
+ *
+ * 	Routes containers through the allocator backend of the library, and
+ * 	with it through its thread caches and statistics. Thread safe, all
+ * 	instances compare equal.
+ *
+ * 	std::pmr::vector<int> v(lib_convention::heap_resource());
+ * ****************************************************************************/
+class heap_memory_resource final : public std::pmr::memory_resource {
+private:
+	void* do_allocate(std::size_t _bytes, std::size_t _align) override
+	{
+		void *mem = nullptr;
+
+		if (_align <= alignof(std::max_align_t)) {
+			if (alloc_memory_uninit(&mem, 1, (_bytes != 0) ? _bytes : 1) < 0) {
+				throw std::bad_alloc();
+			}
+			return mem;
+		}
+
+		mem = alloc_memory_aligned(1, _bytes, _align);
+		if (mem == nullptr) {
+			throw std::bad_alloc();
+		}
+		return mem;
+	}
+
+	void do_deallocate(void *_mem, std::size_t _bytes, std::size_t _align) override
+	{
+		if (_align <= alignof(std::max_align_t)) {
+			free_memory_sized(_mem, (_bytes != 0) ? _bytes : 1);
+		}
+		else {
+			free_memory_aligned(_mem);
+		}
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource &_other) const noexcept override
+	{
+		return dynamic_cast<const heap_memory_resource*>(&_other) != nullptr;
+	}
+};
+
+/* ************************************************************************//**
+ * \brief	Process wide instance of heap_memory_resource
+ * ****************************************************************************/
+inline std::pmr::memory_resource* heap_resource(void) noexcept
+{
+	static heap_memory_resource s_heap;
+
+	return &s_heap;
+}
+
+/* ************************************************************************//**
+ * \brief	Monotonic std::pmr::memory_resource on a mem_arena
+ *
+ * 	Deallocation is a no-op, the memory of all objects is released at once
+ * 	by release() or the destructor. Chunks are kept on release(), so a
+ * 	scratch resource reused per request stops calling the heap. Not thread
+ * 	safe.
+ *
+ * \param	_chunk_size	: payload size of the arena chunks in bytes
+ * ****************************************************************************/
+class arena_resource final : public std::pmr::memory_resource {
+public:
+	explicit arena_resource(std::size_t _chunk_size = s_default_chunk)
+	{
+		if (mem_arena__create(&m_arena, _chunk_size) < 0) {
+			throw std::bad_alloc();
+		}
+	}
+
+	~arena_resource() override
+	{
+		(void)mem_arena__destroy(&m_arena);
+	}
+
+	arena_resource(const arena_resource&) = delete;
+	arena_resource& operator=(const arena_resource&) = delete;
+
+	/* ************************************************************************//**
+	 * \brief	Release the memory of all objects, the containers using the
+	 * 			resource must not be touched afterwards
+	 * ****************************************************************************/
+	void release(void) noexcept
+	{
+		(void)mem_arena__reset(m_arena);
+	}
+
+	static constexpr std::size_t s_default_chunk = 64U * 1024U;
+
+private:
+	void* do_allocate(std::size_t _bytes, std::size_t _align) override
+	{
+		void *mem = mem_arena__alloc(m_arena, _bytes, _align);
+
+		if (mem == nullptr) {
+			throw std::bad_alloc();
+		}
+		return mem;
+	}
+
+	void do_deallocate(void*, std::size_t, std::size_t) override
+	{
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource &_other) const noexcept override
+	{
+		return this == &_other;
+	}
+
+	struct mem_arena *m_arena = nullptr;
+};
+
+/* ************************************************************************//**
+ * \brief	Pooling std::pmr::memory_resource for node based containers
+ *
+ * 	Blocks up to s_max_block bytes are rounded to a power of two size class
+ * 	and recycled through a free list per class, new blocks are carved from
+ * 	a mem_arena. Larger or over-aligned blocks go to heap_resource(). Not
+ * 	thread safe, one instance per thread or container.
+ *
+ * \param	_chunk_size	: payload size of the arena chunks in bytes
+ * ****************************************************************************/
+class pool_resource final : public std::pmr::memory_resource {
+public:
+	explicit pool_resource(std::size_t _chunk_size = arena_resource::s_default_chunk)
+	{
+		if (mem_arena__create(&m_arena, _chunk_size) < 0) {
+			throw std::bad_alloc();
+		}
+	}
+
+	~pool_resource() override
+	{
+		(void)mem_arena__destroy(&m_arena);
+	}
+
+	pool_resource(const pool_resource&) = delete;
+	pool_resource& operator=(const pool_resource&) = delete;
+
+	/* ************************************************************************//**
+	 * \brief	Release all pooled blocks at once, blocks served by the heap
+	 * 			still have to be deallocated
+	 * ****************************************************************************/
+	void release(void) noexcept
+	{
+		for (auto &head : m_free) {
+			head = nullptr;
+		}
+		(void)mem_arena__reset(m_arena);
+	}
+
+	static constexpr std::size_t s_min_block = 16U;
+	static constexpr std::size_t s_max_block = 1024U;
+
+private:
+	struct free_block {
+		free_block *next;
+	};
+
+	static constexpr unsigned s_min_shift = 4U;
+	static constexpr unsigned s_classes = 7U;
+
+	static unsigned size_class(std::size_t _bytes, std::size_t _align) noexcept
+	{
+		std::size_t size = (_bytes > _align) ? _bytes : _align;
+
+		if (size <= s_min_block) {
+			return 0;
+		}
+		return (unsigned)bit__fls64((uint64_t)(size - 1U)) + 1U - s_min_shift;
+	}
+
+	static bool pooled(std::size_t _bytes, std::size_t _align) noexcept
+	{
+		return (_bytes <= s_max_block) && (_align <= MEM__CACHE_LINE);
+	}
+
+	void* do_allocate(std::size_t _bytes, std::size_t _align) override
+	{
+		std::size_t block;
+		unsigned cls;
+		void *mem;
+
+		if (!pooled(_bytes, _align)) {
+			return heap_resource()->allocate(_bytes, _align);
+		}
+
+		cls = size_class(_bytes, _align);
+		if (m_free[cls] != nullptr) {
+			mem = m_free[cls];
+			m_free[cls] = m_free[cls]->next;
+			return mem;
+		}
+
+		/* blocks of a class share one alignment, so recycled blocks fit every request */
+		block = s_min_block << cls;
+		mem = mem_arena__alloc(m_arena, block, (block < MEM__CACHE_LINE) ? block : MEM__CACHE_LINE);
+		if (mem == nullptr) {
+			throw std::bad_alloc();
+		}
+		return mem;
+	}
+
+	void do_deallocate(void *_mem, std::size_t _bytes, std::size_t _align) override
+	{
+		free_block *block;
+		unsigned cls;
+
+		if (!pooled(_bytes, _align)) {
+			heap_resource()->deallocate(_mem, _bytes, _align);
+			return;
+		}
+
+		cls = size_class(_bytes, _align);
+		block = static_cast<free_block*>(_mem);
+		block->next = m_free[cls];
+		m_free[cls] = block;
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource &_other) const noexcept override
+	{
+		return this == &_other;
+	}
+
+	struct mem_arena *m_arena = nullptr;
+	free_block *m_free[s_classes] = {};
+};
+
+} /* namespace lib_convention */
+
+#endif /* LIB_CONVENTION__MEMORY_RESOURCE_HPP_ */
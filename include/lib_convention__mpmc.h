@@ -0,0 +1,143 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__MPMC_H_
+#define LIB_CONVENTION__MPMC_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib_convention__macro.h>
+#include <lib_convention__mem.h>
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Slot of the queue, seq tells producers and consumers whose turn
+ * 			it is
+ * ****************************************************************************/
+struct mpmc_cell {
+	uintptr_t seq;
+	void *data;
+};
+
+/* ************************************************************************//**
+ * \brief	Lock-free bounded multi-producer/multi-consumer queue
+ *
+ * 	Producers and consumers claim positions with a CAS on their index
+ * 	and synchronize per cell, so they only contend among themselves.
+ * 	Both indices are on their own cache line.
+ * ****************************************************************************/
+struct mpmc_queue {
+	struct mpmc_cell *cells;
+	uintptr_t mask;
+	uint8_t pad0[MEM__CACHE_LINE];
+
+	uintptr_t enqueue_pos;
+	uint8_t pad1[MEM__CACHE_LINE];
+
+	uintptr_t dequeue_pos;
+	uint8_t pad2[MEM__CACHE_LINE];
+};
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Number of slots of a queue for at least _count items
+ * ****************************************************************************/
+#define MPMC_QUEUE__CAPACITY(_count)		ALIGN_POW2(_count)
+
+/* ************************************************************************//**
+ * \brief	Size of the buffer which has to be supplied for a queue, a
+ * 			multiple of the cache line
+ *
+ * \param	_count	: number of items the queue has to hold
+ * ****************************************************************************/
+#define MPMC_QUEUE__BUFFER_SIZE(_count)		\
+			ALIGN(MPMC_QUEUE__CAPACITY(_count) * sizeof(struct mpmc_cell), MEM__CACHE_LINE)
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Set up an empty queue over caller supplied memory
+ *
+ * \param	_queue		: queue to initialize
+ * \param	_buffer		: memory of MPMC_QUEUE__BUFFER_SIZE(_count) bytes,
+ * 						  preferably cache line aligned
+ * \param	_buffer_size: size of _buffer in bytes
+ * \param	_count		: number of items, rounded up to a power of two
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mpmc_queue__init(struct mpmc_queue *_queue, void *_buffer, size_t _buffer_size, unsigned int _count);
+
+/* ************************************************************************//**
+ * \brief	Append an item
+ *
+ * \param	_queue		: queue
+ * \param	_item		: item to append
+ * \return	EOK if successful, -ELIST_OVERFLOW if the queue is full
+ * ****************************************************************************/
+int mpmc_queue__push(struct mpmc_queue *_queue, void *_item);
+
+/* ************************************************************************//**
+ * \brief	Take the oldest item
+ *
+ * \param	_queue		: queue
+ * \param	_item		: the item is passed to this pointer
+ * \return	EOK if successful, -ESTD_AGAIN if the queue is empty
+ * ****************************************************************************/
+int mpmc_queue__pop(struct mpmc_queue *_queue, void **_item);
+
+/* ************************************************************************//**
+ * \brief	Append up to _count items with a single claim of the index
+ *
+ * \param	_queue		: queue
+ * \param	_items		: items to append
+ * \param	_count		: number of items
+ * \return	number of appended items, in order from _items[0], or
+ * 			-ELIST_OVERFLOW if the queue is full
+ * ****************************************************************************/
+int mpmc_queue__push_bulk(struct mpmc_queue *_queue, void *const *_items, unsigned int _count);
+
+/* ************************************************************************//**
+ * \brief	Take up to _count of the oldest items with a single claim
+ *
+ * \param	_queue		: queue
+ * \param	_items		: buffer the items are passed to
+ * \param	_count		: number of entries of _items
+ * \return	number of items taken, or -ESTD_AGAIN if the queue is empty
+ * ****************************************************************************/
+int mpmc_queue__pop_bulk(struct mpmc_queue *_queue, void **_items, unsigned int _count);
+
+#endif /* LIB_CONVENTION__MPMC_H_ */
@@ -0,0 +1,205 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__MSGBUF_H_
+#define LIB_CONVENTION__MSGBUF_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <sys/uio.h>
+#endif
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+struct msgbuf_pool;
+struct msgbuf_block;
+
+/* ************************************************************************//**
+ * \brief	Scatter-gather element, struct iovec where the system has one
+ * ****************************************************************************/
+#if defined(__unix__) || defined(__APPLE__)
+typedef struct iovec msgbuf_iovec_t;
+#else
+typedef struct {
+	void *iov_base;
+	size_t iov_len;
+} msgbuf_iovec_t;
+#endif
+
+/* ************************************************************************//**
+ * \brief	View on a reference counted data block of a msgbuf_pool
+ *
+ * 	Several views may share a block, e.g. after msgbuf__slice(). Views
+ * 	are chained by next to form a message out of several fragments.
+ *
+ * \param	next	: next fragment of the message
+ * \param	data	: first byte of the view
+ * \param	len		: number of bytes of the view
+ * ****************************************************************************/
+struct msgbuf {
+	struct msgbuf *next;
+	uint8_t *data;
+	size_t len;
+	struct msgbuf_block *block;
+	struct msgbuf_pool *pool;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Create a pool of message buffers
+ *
+ * 	Blocks and views are preallocated, alloc and free are lock-free and
+ * 	may be called from any thread.
+ *
+ * \param	_pool		: created pool is passed to this pointer
+ * \param	_blocks		: number of data blocks
+ * \param	_block_size	: size of a data block in bytes
+ * \param	_views		: number of views, at least _blocks
+ * \param	_headroom	: bytes kept free in front of a new buffer for
+ * 						  headers prepended by msgbuf__push()
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int msgbuf_pool__create(struct msgbuf_pool **_pool, unsigned int _blocks, size_t _block_size,
+						unsigned int _views, size_t _headroom);
+
+/* ************************************************************************//**
+ * \brief	Release a pool, all buffers have to be freed before
+ *
+ * \param	_pool		: pool to destroy, set to NULL afterwards
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int msgbuf_pool__destroy(struct msgbuf_pool **_pool);
+
+/* ************************************************************************//**
+ * \brief	Take an empty buffer with the headroom of the pool in front
+ *
+ * \param	_pool		: pool
+ * \return	buffer of length 0, or NULL if the pool is exhausted
+ * ****************************************************************************/
+struct msgbuf* msgbuf__alloc(struct msgbuf_pool *_pool);
+
+/* ************************************************************************//**
+ * \brief	Release all views of a chain, blocks are returned to the pool
+ * 			with their last view
+ *
+ * \param	_buf		: first view of the chain, may be NULL
+ * ****************************************************************************/
+void msgbuf__free(struct msgbuf *_buf);
+
+/* ************************************************************************//**
+ * \brief	Create a view on a part of a buffer without copying
+ *
+ * \param	_buf		: buffer to slice
+ * \param	_offset		: offset of the slice within _buf
+ * \param	_len		: length of the slice
+ * \return	new view sharing the block of _buf, or NULL on error
+ * ****************************************************************************/
+struct msgbuf* msgbuf__slice(struct msgbuf *_buf, size_t _offset, size_t _len);
+
+/* ************************************************************************//**
+ * \brief	Extend the buffer at its end
+ *
+ * 	Only allowed while the view is the only one on its block.
+ *
+ * \param	_buf		: buffer
+ * \param	_len		: number of bytes to append
+ * \return	pointer to the appended bytes, or NULL if the tailroom is too
+ * 			small or the block is shared
+ * ****************************************************************************/
+uint8_t* msgbuf__put(struct msgbuf *_buf, size_t _len);
+
+/* ************************************************************************//**
+ * \brief	Extend the buffer at its front into the headroom, e.g. for a
+ * 			protocol header
+ *
+ * 	Only allowed while the view is the only one on its block.
+ *
+ * \param	_buf		: buffer
+ * \param	_len		: number of bytes to prepend
+ * \return	pointer to the prepended bytes, or NULL if the headroom is too
+ * 			small or the block is shared
+ * ****************************************************************************/
+uint8_t* msgbuf__push(struct msgbuf *_buf, size_t _len);
+
+/* ************************************************************************//**
+ * \brief	Strip bytes from the front of the buffer, e.g. a parsed header
+ *
+ * \param	_buf		: buffer
+ * \param	_len		: number of bytes to strip
+ * \return	pointer to the stripped bytes, or NULL if the buffer is shorter
+ * ****************************************************************************/
+uint8_t* msgbuf__pull(struct msgbuf *_buf, size_t _len);
+
+/* ************************************************************************//**
+ * \brief	Free bytes in front of or behind the view
+ * ****************************************************************************/
+size_t msgbuf__headroom(const struct msgbuf *_buf);
+size_t msgbuf__tailroom(const struct msgbuf *_buf);
+
+/* ************************************************************************//**
+ * \brief	Append a chain to the end of another chain
+ *
+ * \param	_head		: first view of the chain to extend
+ * \param	_tail		: chain to append
+ * ****************************************************************************/
+void msgbuf__chain(struct msgbuf *_head, struct msgbuf *_tail);
+
+/* ************************************************************************//**
+ * \brief	Sum of the lengths of all views of a chain
+ * ****************************************************************************/
+size_t msgbuf__length(const struct msgbuf *_buf);
+
+/* ************************************************************************//**
+ * \brief	Describe a chain as scatter-gather array, e.g. for the msg_iov
+ * 			of sendmsg()/sendmmsg()
+ *
+ * \param	_buf		: first view of the chain
+ * \param	_iov		: array the elements are passed to
+ * \param	_max		: number of entries of _iov
+ * \return	number of elements, -ELIST_OVERFLOW if _iov is too short
+ * ****************************************************************************/
+int msgbuf__to_iovec(const struct msgbuf *_buf, msgbuf_iovec_t *_iov, unsigned int _max);
+
+/* ************************************************************************//**
+ * \brief	Describe the tailroom of a buffer as scatter-gather element, e.g.
+ * 			for the msg_iov of recvmsg()/recvmmsg()
+ *
+ * 	The received bytes are committed with msgbuf__put().
+ *
+ * \param	_buf		: empty or exclusively owned buffer
+ * \param	_iov		: the element is passed to this pointer
+ * ****************************************************************************/
+void msgbuf__tail_iovec(const struct msgbuf *_buf, msgbuf_iovec_t *_iov);
+
+#endif /* LIB_CONVENTION__MSGBUF_H_ */
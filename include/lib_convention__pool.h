@@ -0,0 +1,129 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__POOL_H_
+#define LIB_CONVENTION__POOL_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib_convention__macro.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Alignment of every block and of the buffer passed to mem_pool__init()
+ * ****************************************************************************/
+#define MEM_POOL__BLOCK_ALIGN		8U
+
+/* ************************************************************************//**
+ * \brief	Flags of mem_pool__init()
+ *
+ * 	MEM_POOL__FLAG_LOCKFREE	: alloc and free may be called concurrently from
+ * 							  threads and interrupt handlers
+ * ****************************************************************************/
+#define MEM_POOL__FLAG_NONE			0x0U
+#define MEM_POOL__FLAG_LOCKFREE		0x1U
+
+/* ************************************************************************//**
+ * \brief	Size of the buffer which has to be supplied for a pool
+ *
+ * \param	_block_size	: size of a single block in bytes
+ * \param	_count		: number of blocks
+ * ****************************************************************************/
+#define MEM_POOL__STRIDE(_block_size)	\
+			ALIGN(((_block_size) < sizeof(uint32_t) ? sizeof(uint32_t) : (_block_size)), MEM_POOL__BLOCK_ALIGN)
+
+#define MEM_POOL__BUFFER_SIZE(_block_size, _count)	(MEM_POOL__STRIDE(_block_size) * (_count))
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Head of the free list, index of the first free block tagged with
+ * 			a modification counter to avoid ABA on the lock-free variant
+ * ****************************************************************************/
+#if UINTPTR_MAX > 0xFFFFFFFFU
+typedef uint64_t mem_pool_head_t;
+#else
+typedef uint32_t mem_pool_head_t;
+#endif
+
+/* ************************************************************************//**
+ * \brief	Fixed-block pool, may be placed in static memory
+ * ****************************************************************************/
+struct mem_pool {
+	uint8_t *base;
+	size_t stride;
+	uint32_t count;
+	uint32_t flags;
+	mem_pool_head_t head;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Set up a pool over caller supplied memory
+ *
+ * \param	_pool		: pool to initialize
+ * \param	_buffer		: memory of at least MEM_POOL__BUFFER_SIZE(_block_size, _count)
+ * 						  bytes, aligned to MEM_POOL__BLOCK_ALIGN
+ * \param	_buffer_size: size of _buffer in bytes
+ * \param	_block_size	: size of a single block in bytes
+ * \param	_count		: number of blocks
+ * \param	_flags		: MEM_POOL__FLAG_NONE or MEM_POOL__FLAG_LOCKFREE
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_pool__init(struct mem_pool *_pool, void *_buffer, size_t _buffer_size,
+				   size_t _block_size, unsigned int _count, unsigned int _flags);
+
+/* ************************************************************************//**
+ * \brief	Take a block from the pool in constant time
+ *
+ * 	The content of the block is not initialized.
+ *
+ * \param	_pool		: pool to allocate from
+ * \return	pointer to the block, or NULL if the pool is exhausted
+ * ****************************************************************************/
+void* mem_pool__alloc(struct mem_pool *_pool);
+
+/* ************************************************************************//**
+ * \brief	Return a block to the pool in constant time
+ *
+ * \param	_pool		: pool the block was taken from
+ * \param	_mem		: block to release
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int mem_pool__free(struct mem_pool *_pool, void *_mem);
+
+#endif /* LIB_CONVENTION__POOL_H_ */
@@ -0,0 +1,146 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__RBTREE_H_
+#define LIB_CONVENTION__RBTREE_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib_convention__macro.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Object which embeds the node
+ * ****************************************************************************/
+#define RBTREE__ENTRY(_node, _type, _member)	((_type*)GET_CONTAINER_OF(_node, _type, _member))
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Hook embedded into the objects of a tree
+ *
+ * 	The color is stored in the lowest bit of the parent pointer, so a
+ * 	node takes three words.
+ * ****************************************************************************/
+struct rbtree_node {
+	uintptr_t parent_color;
+	struct rbtree_node *left;
+	struct rbtree_node *right;
+};
+
+/* ************************************************************************//**
+ * \brief	Intrusive red-black tree
+ * ****************************************************************************/
+struct rbtree {
+	struct rbtree_node *root;
+};
+
+/* ************************************************************************//**
+ * \brief	Order of two nodes of the tree
+ * \return	negative, zero or positive if _a is below, equal to or above _b
+ * ****************************************************************************/
+typedef int (*rbtree_cmp_t)(const struct rbtree_node *_a, const struct rbtree_node *_b);
+
+/* ************************************************************************//**
+ * \brief	Order of a key and a node of the tree
+ * \return	negative, zero or positive if _key is below, equal to or above _node
+ * ****************************************************************************/
+typedef int (*rbtree_cmp_key_t)(const void *_key, const struct rbtree_node *_node);
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Insert a node in O(log n)
+ *
+ * \param	_tree	: tree
+ * \param	_node	: node to insert
+ * \param	_cmp	: order of the nodes
+ * \return	EOK if successful, -ESTD_EXIST if an equal node is stored
+ * ****************************************************************************/
+int rbtree__insert(struct rbtree *_tree, struct rbtree_node *_node, rbtree_cmp_t _cmp);
+
+/* ************************************************************************//**
+ * \brief	Remove a node in O(log n)
+ *
+ * \param	_tree	: tree
+ * \param	_node	: node of the tree to remove
+ * ****************************************************************************/
+void rbtree__remove(struct rbtree *_tree, struct rbtree_node *_node);
+
+/* ************************************************************************//**
+ * \brief	Look up a key
+ *
+ * \param	_tree	: tree
+ * \param	_key	: key passed to the comparison
+ * \param	_cmp	: order of key and nodes
+ * \return	the node equal to the key, or NULL if there is none
+ * ****************************************************************************/
+struct rbtree_node* rbtree__find(const struct rbtree *_tree, const void *_key, rbtree_cmp_key_t _cmp);
+
+/* ************************************************************************//**
+ * \brief	Look up the first node which is not below the key
+ *
+ * \param	_tree	: tree
+ * \param	_key	: key passed to the comparison
+ * \param	_cmp	: order of key and nodes
+ * \return	the node, or NULL if all nodes are below the key
+ * ****************************************************************************/
+struct rbtree_node* rbtree__lower_bound(const struct rbtree *_tree, const void *_key, rbtree_cmp_key_t _cmp);
+
+/* ************************************************************************//**
+ * \brief	In-order traversal
+ * \return	the node, or NULL if there is none
+ * ****************************************************************************/
+struct rbtree_node* rbtree__first(const struct rbtree *_tree);
+struct rbtree_node* rbtree__last(const struct rbtree *_tree);
+struct rbtree_node* rbtree__next(const struct rbtree_node *_node);
+struct rbtree_node* rbtree__prev(const struct rbtree_node *_node);
+
+/* *******************************************************************
+ * static inline function
+ * ******************************************************************/
+
+static inline void rbtree__init(struct rbtree *_tree)
+{
+	_tree->root = NULL;
+}
+
+static inline int rbtree__empty(const struct rbtree *_tree)
+{
+	return _tree->root == NULL;
+}
+
+#endif /* LIB_CONVENTION__RBTREE_H_ */
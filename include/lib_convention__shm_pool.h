@@ -0,0 +1,206 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef LIB_CONVENTION__SHM_POOL_H_
+#define LIB_CONVENTION__SHM_POOL_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Alignment of the blocks inside of the shared region
+ * ****************************************************************************/
+#define SHM_POOL__BLOCK_ALIGN	64U
+
+/* ************************************************************************//**
+ * \brief	Offset which never refers to a block, offset 0 holds the header
+ * ****************************************************************************/
+#define SHM_POOL__NULL			((shm_off_t)0)
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+struct shm_pool;
+
+/* ************************************************************************//**
+ * \brief	Position independent reference to a block
+ *
+ * 	Every process maps the region at a different address, so blocks are
+ * 	exchanged as offsets from the start of the region and converted with
+ * 	shm_pool__ptr() and shm_pool__off().
+ * ****************************************************************************/
+typedef uint64_t shm_off_t;
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Create a shared region and carve it into fixed size blocks
+ *
+ * 	A named region is created with shm_open() and can be opened by other
+ * 	processes with shm_pool__open(). Without a name an anonymous memfd is
+ * 	used, its descriptor (shm_pool__fd()) is passed to the other processes,
+ * 	e.g. over a unix socket, and opened with shm_pool__open_fd().
+ *
+ * \param	_pool		: process local handle is passed to this pointer
+ * \param	_name		: name of the region starting with '/', or NULL
+ * \param	_block_size	: size of a single block in bytes
+ * \param	_blocks		: number of blocks
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int shm_pool__create(struct shm_pool **_pool, const char *_name, size_t _block_size, unsigned int _blocks);
+
+/* ************************************************************************//**
+ * \brief	Map a region created by another process by its name
+ *
+ * \param	_pool		: process local handle is passed to this pointer
+ * \param	_name		: name passed to shm_pool__create()
+ * \return	EOK if successful, -ESTD_AGAIN if the creator has not finished
+ * 			the set up yet, or negative errno value on error
+ * ****************************************************************************/
+int shm_pool__open(struct shm_pool **_pool, const char *_name);
+
+/* ************************************************************************//**
+ * \brief	Map a region by a descriptor received from another process
+ *
+ * \param	_pool		: process local handle is passed to this pointer
+ * \param	_fd			: descriptor of the region, it is duplicated
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int shm_pool__open_fd(struct shm_pool **_pool, int _fd);
+
+/* ************************************************************************//**
+ * \brief	Unmap a region from the calling process
+ *
+ * 	Blocks owned by the process stay allocated, they are reclaimed by
+ * 	shm_pool__recover() once the process has exited.
+ *
+ * \param	_pool		: handle to close, set to NULL afterwards
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int shm_pool__close(struct shm_pool **_pool);
+
+/* ************************************************************************//**
+ * \brief	Remove the name of a region, mappings stay valid until closed
+ *
+ * \param	_name		: name passed to shm_pool__create()
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int shm_pool__unlink(const char *_name);
+
+/* ************************************************************************//**
+ * \brief	Descriptor of the region to share it with other processes
+ * ****************************************************************************/
+int shm_pool__fd(const struct shm_pool *_pool);
+
+/* ************************************************************************//**
+ * \brief	Take a block, lock-free with respect to all attached processes
+ *
+ * 	The calling process becomes the owner of the block. The content of the
+ * 	block is not initialized. Allocations wait while shm_pool__recover()
+ * 	rebuilds the free list.
+ *
+ * \param	_pool		: pool to allocate from
+ * \param	_off		: offset of the block is passed to this pointer
+ * \return	EOK if successful, -ESTD_NOMEM if the pool is exhausted, or
+ * 			negative errno value on error
+ * ****************************************************************************/
+int shm_pool__alloc(struct shm_pool *_pool, shm_off_t *_off);
+
+/* ************************************************************************//**
+ * \brief	Return a block, may be called by any attached process
+ *
+ * \param	_pool		: pool the block was taken from
+ * \param	_off		: offset of the block
+ * \return	EOK if successful, -EPAR_BADVALUE if the block is not allocated,
+ * 			or negative errno value on error
+ * ****************************************************************************/
+int shm_pool__free(struct shm_pool *_pool, shm_off_t _off);
+
+/* ************************************************************************//**
+ * \brief	Take over the ownership of a block handed over by another process
+ *
+ * 	The receiver should adopt a block before the sender may exit, otherwise
+ * 	shm_pool__recover() reclaims it together with the other blocks of the
+ * 	sender.
+ *
+ * \param	_pool		: pool the block was taken from
+ * \param	_off		: offset of the block
+ * \return	EOK if successful, -EPAR_BADVALUE if the block is not allocated,
+ * 			or negative errno value on error
+ * ****************************************************************************/
+int shm_pool__adopt(struct shm_pool *_pool, shm_off_t _off);
+
+/* ************************************************************************//**
+ * \brief	Return the blocks of processes which exited without freeing them
+ *
+ * 	Waits until no live process is within shm_pool__alloc() or
+ * 	shm_pool__free(), then releases the blocks of dead owners and rebuilds
+ * 	the free list and the number of available blocks from the owners. This
+ * 	also returns blocks of processes killed in the middle of an allocation
+ * 	or release. If the recovering process is killed, the next operation
+ * 	completes the recovery. A process which has exited but is not reaped
+ * 	yet counts as dead. Blocks of a dead process are missed if its pid was
+ * 	already reused.
+ *
+ * \param	_pool		: pool to scan
+ * \return	number of reclaimed blocks, or negative errno value on error
+ * ****************************************************************************/
+int shm_pool__recover(struct shm_pool *_pool);
+
+/* ************************************************************************//**
+ * \brief	Convert an offset into an address of the calling process
+ *
+ * \return	address of the block, or NULL if the offset is out of the region
+ * ****************************************************************************/
+void* shm_pool__ptr(const struct shm_pool *_pool, shm_off_t _off);
+
+/* ************************************************************************//**
+ * \brief	Convert an address of the calling process into an offset
+ *
+ * \return	offset inside of the region, or SHM_POOL__NULL
+ * ****************************************************************************/
+shm_off_t shm_pool__off(const struct shm_pool *_pool, const void *_mem);
+
+/* ************************************************************************//**
+ * \brief	Usable size of a block in bytes
+ * ****************************************************************************/
+size_t shm_pool__block_size(const struct shm_pool *_pool);
+
+/* ************************************************************************//**
+ * \brief	Number of free blocks, a snapshot only
+ * ****************************************************************************/
+unsigned int shm_pool__available(const struct shm_pool *_pool);
+
+#endif /* LIB_CONVENTION__SHM_POOL_H_ */
@@ -0,0 +1,224 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef LIB_CONVENTION__SLOTMAP_H_
+#define LIB_CONVENTION__SLOTMAP_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib_convention__macro.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Layout of a handle
+ *
+ * 	The slot index is kept in the low SLOTMAP__INDEX_BITS, the generation of
+ * 	the slot in the remaining high bits. Handles are 32 bit wide (1M slots,
+ * 	4096 generations) unless the library is built with
+ * 	LIB_CONVENTION_SLOTMAP_HANDLE64 (4G slots, 4G generations), which
+ * 	exports CONFIG__SLOTMAP_HANDLE64 to every target linking the library.
+ * ****************************************************************************/
+#ifdef CONFIG__SLOTMAP_HANDLE64
+	#define SLOTMAP__HANDLE_BITS	64U
+	#define SLOTMAP__INDEX_BITS		32U
+#else
+	#define SLOTMAP__HANDLE_BITS	32U
+	#define SLOTMAP__INDEX_BITS		20U
+#endif
+
+#define SLOTMAP__INDEX_MASK		((slotmap_handle_t)BIT_FIELD_MASK(SLOTMAP__INDEX_BITS - 1, 0))
+#define SLOTMAP__GEN_MASK		((slotmap_handle_t)BIT_FIELD_MASK(SLOTMAP__HANDLE_BITS - 1, SLOTMAP__INDEX_BITS))
+
+/* ************************************************************************//**
+ * \brief	Largest number of entries of a slot map
+ * ****************************************************************************/
+#define SLOTMAP__MAX_ENTRIES	((uint32_t)SLOTMAP__INDEX_MASK)
+
+/* ************************************************************************//**
+ * \brief	Handle value which never refers to an entry
+ *
+ * 	Live slots have an odd generation, so no valid handle is zero.
+ * ****************************************************************************/
+#define SLOTMAP__INVALID		((slotmap_handle_t)0)
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+#ifdef CONFIG__SLOTMAP_HANDLE64
+typedef uint64_t slotmap_handle_t;
+#else
+typedef uint32_t slotmap_handle_t;
+#endif
+
+/* ************************************************************************//**
+ * \brief	Indirection of a handle
+ *
+ * \param	index	: position in the dense array while the slot is live,
+ * 					  next free slot otherwise
+ * \param	gen		: generation, odd while the slot is live
+ * ****************************************************************************/
+struct slotmap_slot {
+	uint32_t index;
+	uint32_t gen;
+};
+
+/* ************************************************************************//**
+ * \brief	Generational handle table
+ *
+ * 	The entries are kept densely packed in values, so iterating all of them
+ * 	is a linear scan over slotmap__at(0 .. count-1). Erasing moves the last
+ * 	entry into the gap, pointers into the table are only valid until the
+ * 	next insert or erase. The table is not thread-safe.
+ * ****************************************************************************/
+struct slotmap {
+	uint8_t *values;
+	uint32_t *owners;
+	struct slotmap_slot *slots;
+	size_t elem_size;
+	uint32_t count;
+	uint32_t capacity;
+	uint32_t slot_count;
+	uint32_t free_head;
+	uint32_t free_tail;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Set up an empty table
+ *
+ * \param	_map		: table to initialize
+ * \param	_elem_size	: size of an entry in bytes
+ * \param	_capacity	: number of entries storage is reserved for, the
+ * 						  table grows on demand
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int slotmap__init(struct slotmap *_map, size_t _elem_size, unsigned int _capacity);
+
+/* ************************************************************************//**
+ * \brief	Release the storage of a table, all handles become stale
+ *
+ * \param	_map		: table to release
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int slotmap__destroy(struct slotmap *_map);
+
+/* ************************************************************************//**
+ * \brief	Add an entry in constant (amortized) time
+ *
+ * \param	_map		: table to insert to
+ * \param	_value		: entry which is copied into the table, NULL inserts a
+ * 						  zero initialized entry
+ * \param	_handle		: handle of the new entry is passed to this pointer
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int slotmap__insert(struct slotmap *_map, const void *_value, slotmap_handle_t *_handle);
+
+/* ************************************************************************//**
+ * \brief	Remove an entry in constant time
+ *
+ * \param	_map		: table to remove from
+ * \param	_handle		: handle of the entry
+ * \return	EOK if successful, -EPAR_INVCHN if the handle is stale
+ * ****************************************************************************/
+int slotmap__erase(struct slotmap *_map, slotmap_handle_t _handle);
+
+/* ************************************************************************//**
+ * \brief	Resolve a handle in constant time
+ *
+ * \param	_map		: table to investigate
+ * \param	_handle		: handle of the entry
+ * \param	_value		: pointer to the entry is passed to this pointer
+ * \return	EOK if successful, -EPAR_INVCHN if the handle is stale
+ * ****************************************************************************/
+int slotmap__lookup(const struct slotmap *_map, slotmap_handle_t _handle, void **_value);
+
+/* ************************************************************************//**
+ * \brief	Remove all entries, all handles become stale
+ *
+ * \param	_map		: table to clear
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int slotmap__clear(struct slotmap *_map);
+
+/* *******************************************************************
+ * static inline function
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Resolve a handle without error code
+ *
+ * \return	pointer to the entry, or NULL if the handle is stale
+ * ****************************************************************************/
+static inline void* slotmap__get(const struct slotmap *_map, slotmap_handle_t _handle)
+{
+	uint32_t index = (uint32_t)(_handle & SLOTMAP__INDEX_MASK);
+	uint32_t gen = (uint32_t)((_handle & SLOTMAP__GEN_MASK) >> SLOTMAP__INDEX_BITS);
+	const struct slotmap_slot *slot;
+
+	if (index >= _map->slot_count) {
+		return NULL;
+	}
+	slot = &_map->slots[index];
+	if ((slot->gen != gen) || !(gen & 1U)) {
+		return NULL;
+	}
+	return _map->values + ((size_t)slot->index * _map->elem_size);
+}
+
+static inline uint32_t slotmap__count(const struct slotmap *_map)
+{
+	return _map->count;
+}
+
+/* ************************************************************************//**
+ * \brief	Entry at a dense position in the range 0 .. slotmap__count()-1
+ * ****************************************************************************/
+static inline void* slotmap__at(const struct slotmap *_map, uint32_t _pos)
+{
+	return _map->values + ((size_t)_pos * _map->elem_size);
+}
+
+/* ************************************************************************//**
+ * \brief	Handle of the entry at a dense position
+ * ****************************************************************************/
+static inline slotmap_handle_t slotmap__handle_at(const struct slotmap *_map, uint32_t _pos)
+{
+	uint32_t index = _map->owners[_pos];
+
+	return ((slotmap_handle_t)_map->slots[index].gen << SLOTMAP__INDEX_BITS) | (slotmap_handle_t)index;
+}
+
+#endif /* LIB_CONVENTION__SLOTMAP_H_ */
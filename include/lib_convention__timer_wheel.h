@@ -0,0 +1,211 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__TIMER_WHEEL_H_
+#define LIB_CONVENTION__TIMER_WHEEL_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include <lib_convention__ilist.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Geometry of the wheel
+ *
+ * 	Each level covers TIMER_WHEEL__SLOTS times the range of the level below,
+ * 	timers further out than TIMER_WHEEL__RANGE ticks are parked on the top
+ * 	level and placed again when it turns.
+ * ****************************************************************************/
+#define TIMER_WHEEL__SLOT_BITS		6U
+#define TIMER_WHEEL__SLOTS			(1U << TIMER_WHEEL__SLOT_BITS)
+#define TIMER_WHEEL__LEVELS			6U
+#define TIMER_WHEEL__RANGE			(1ULL << (TIMER_WHEEL__SLOT_BITS * TIMER_WHEEL__LEVELS))
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+struct timer_wheel_timer;
+
+/* ************************************************************************//**
+ * \brief	Expiry callback
+ *
+ * 	The timer is already disarmed, the callback may arm it again or
+ * 	release the object which embeds it.
+ * ****************************************************************************/
+typedef void (*timer_wheel_cb_t)(struct timer_wheel_timer *_timer, void *_ctx);
+
+/* ************************************************************************//**
+ * \brief	Timer, embedded into the object it belongs to
+ *
+ * \param	node		: hook of the slot the timer is linked into
+ * \param	expires		: tick the timer is due at
+ * \param	callback	: called by timer_wheel__expire(), may be NULL
+ * 						  if only timer_wheel__advance() is used
+ * \param	ctx			: passed to the callback
+ * \param	slot		: slot of the wheel the timer was placed into
+ * ****************************************************************************/
+struct timer_wheel_timer {
+	struct ilist_node node;
+	uint64_t expires;
+	timer_wheel_cb_t callback;
+	void *ctx;
+	unsigned int slot;
+};
+
+/* ************************************************************************//**
+ * \brief	Hierarchical timing wheel
+ *
+ * 	Arm, cancel and the expiry of a timer take constant time. A bit per
+ * 	slot marks the occupied ones, so idle periods are skipped instead of
+ * 	being walked tick by tick. The wheel is not thread safe.
+ *
+ * \param	tick		: first tick which is not processed yet
+ * \param	pending		: occupied slots of each level
+ * \param	slots		: timers of each slot
+ * ****************************************************************************/
+struct timer_wheel {
+	uint64_t tick;
+	uint64_t pending[TIMER_WHEEL__LEVELS];
+	struct ilist slots[TIMER_WHEEL__LEVELS * TIMER_WHEEL__SLOTS];
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Set up an empty wheel
+ *
+ * \param	_wheel	: wheel to initialize
+ * \param	_now	: current tick, e.g. timer_wheel__clock()
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int timer_wheel__init(struct timer_wheel *_wheel, uint64_t _now);
+
+/* ************************************************************************//**
+ * \brief	Prepare a timer before it is armed the first time
+ *
+ * \param	_timer		: timer to initialize
+ * \param	_callback	: expiry callback
+ * \param	_ctx		: passed to the callback
+ * ****************************************************************************/
+void timer_wheel__timer_init(struct timer_wheel_timer *_timer, timer_wheel_cb_t _callback, void *_ctx);
+
+/* ************************************************************************//**
+ * \brief	Arm a timer, an armed timer is moved to the new expiry
+ *
+ * 	The ticks up to the _now of the last timer_wheel__advance() or
+ * 	timer_wheel__expire() call are already processed. A timer due at one
+ * 	of them expires with the first call passing a later _now, e.g. arming
+ * 	at _now and expiring at the same _now does not run it.
+ *
+ * \param	_wheel		: wheel
+ * \param	_timer		: timer initialized with timer_wheel__timer_init()
+ * \param	_expires	: absolute tick the timer is due at
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int timer_wheel__arm(struct timer_wheel *_wheel, struct timer_wheel_timer *_timer, uint64_t _expires);
+
+/* ************************************************************************//**
+ * \brief	Disarm a timer
+ *
+ * \param	_wheel		: wheel the timer is armed on
+ * \param	_timer		: timer
+ * \return	EOK if successful, -ESTD_NOENT if the timer was not armed
+ * ****************************************************************************/
+int timer_wheel__cancel(struct timer_wheel *_wheel, struct timer_wheel_timer *_timer);
+
+/* ************************************************************************//**
+ * \brief	Advance the wheel and collect the timers which became due
+ *
+ * 	The expired timers are moved to _expired slot by slot, they stay
+ * 	armed until they are removed from it or canceled.
+ *
+ * \param	_wheel		: wheel
+ * \param	_now		: current tick, all timers due at or before are collected
+ * \param	_expired	: list the expired timers are appended to
+ * \return	EOK if successful, or negative errno value on error
+ * ****************************************************************************/
+int timer_wheel__advance(struct timer_wheel *_wheel, uint64_t _now, struct ilist *_expired);
+
+/* ************************************************************************//**
+ * \brief	Advance the wheel and call the callbacks of the expired timers
+ *
+ * 	Timers armed again by a callback with an expiry at or before _now fire
+ * 	with the next call, not within this one.
+ *
+ * \param	_wheel		: wheel
+ * \param	_now		: current tick
+ * \return	number of expired timers, or negative errno value on error
+ * ****************************************************************************/
+int timer_wheel__expire(struct timer_wheel *_wheel, uint64_t _now);
+
+/* ************************************************************************//**
+ * \brief	Tick up to which the caller may sleep without missing a timer
+ *
+ * 	Timers further out than TIMER_WHEEL__RANGE report an earlier tick.
+ *
+ * \param	_wheel		: wheel
+ * \param	_ticks		: the tick is passed to this pointer
+ * \return	EOK if successful, -ESTD_NOENT if no timer is armed
+ * ****************************************************************************/
+int timer_wheel__next_expiry(const struct timer_wheel *_wheel, uint64_t *_ticks);
+
+/* ************************************************************************//**
+ * \brief	Monotonic tick source of the platform
+ *
+ * 	FreeRTOS: scheduler ticks including the overflows of the tick counter,
+ * 	must not be called from an interrupt. Unix: milliseconds of
+ * 	CLOCK_MONOTONIC.
+ *
+ * \return	current tick
+ * ****************************************************************************/
+uint64_t timer_wheel__clock(void);
+
+/* ************************************************************************//**
+ * \brief	Convert a timeout to ticks of timer_wheel__clock(), rounded up
+ *
+ * \param	_ms		: timeout in milliseconds
+ * \return	number of ticks
+ * ****************************************************************************/
+uint64_t timer_wheel__ms_to_ticks(uint64_t _ms);
+
+/* *******************************************************************
+ * static inline function
+ * ******************************************************************/
+
+static inline int timer_wheel__armed(const struct timer_wheel_timer *_timer)
+{
+	return _timer->node.next != &_timer->node;
+}
+
+#endif /* LIB_CONVENTION__TIMER_WHEEL_H_ */
@@ -0,0 +1,238 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__mem.h>
+#include <lib_convention__arena.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define MEM_ARENA__CHUNK_HDR	ALIGN(sizeof(struct mem_arena_chunk), MEM_ARENA__DEFAULT_ALIGN)
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* Chunk header, the payload follows at MEM_ARENA__CHUNK_HDR */
+struct mem_arena_chunk {
+	struct mem_arena_chunk *next;
+	size_t size;
+	size_t used;
+};
+
+struct mem_arena {
+	struct mem_arena_chunk *first;
+	struct mem_arena_chunk *cur;
+	size_t chunk_size;
+};
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static struct mem_arena_chunk* mem_arena__chunk_new(size_t _size);
+static inline void* mem_arena__chunk_take(struct mem_arena_chunk *_chunk, size_t _size, size_t _align);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int mem_arena__create(struct mem_arena **_arena, size_t _chunk_size)
+{
+	struct mem_arena *arena;
+
+	if (_arena == NULL) {
+		return -EPAR_NULL;
+	}
+	if (_chunk_size == 0) {
+		return -EPAR_RANGE;
+	}
+
+	arena = (struct mem_arena*)alloc_memory(1, sizeof(struct mem_arena));
+	if (arena == NULL) {
+		return -ESTD_NOMEM;
+	}
+
+	arena->first = mem_arena__chunk_new(_chunk_size);
+	if (arena->first == NULL) {
+		free_memory(arena);
+		return -ESTD_NOMEM;
+	}
+	arena->cur = arena->first;
+	arena->chunk_size = _chunk_size;
+
+	*_arena = arena;
+	return EOK;
+}
+
+int mem_arena__destroy(struct mem_arena **_arena)
+{
+	struct mem_arena_chunk *chunk, *next;
+
+	if ((_arena == NULL) || (*_arena == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	for (chunk = (*_arena)->first; chunk != NULL; chunk = next) {
+		next = chunk->next;
+		free_memory(chunk);
+	}
+	free_memory(*_arena);
+	*_arena = NULL;
+	return EOK;
+}
+
+void* mem_arena__alloc(struct mem_arena *_arena, size_t _size, size_t _align)
+{
+	struct mem_arena_chunk *chunk;
+	void *mem;
+
+	if (_arena == NULL) {
+		return NULL;
+	}
+	if (_align == 0) {
+		_align = MEM_ARENA__DEFAULT_ALIGN;
+	}
+	if ((_align & (_align - 1)) != 0) {
+		return NULL;
+	}
+
+	mem = mem_arena__chunk_take(_arena->cur, _size, _align);
+	if (mem != NULL) {
+		return mem;
+	}
+
+	/* continue with a chunk kept from before the last reset */
+	chunk = _arena->cur->next;
+	if (chunk != NULL) {
+		chunk->used = 0;
+		mem = mem_arena__chunk_take(chunk, _size, _align);
+		if (mem != NULL) {
+			_arena->cur = chunk;
+			return mem;
+		}
+	}
+
+	if (_size > (SIZE_MAX - MEM_ARENA__CHUNK_HDR - _align)) {
+		return NULL;
+	}
+	chunk = mem_arena__chunk_new((_size + _align > _arena->chunk_size) ? (_size + _align) : _arena->chunk_size);
+	if (chunk == NULL) {
+		return NULL;
+	}
+
+	/* insert behind the current chunk so retained chunks stay reachable */
+	chunk->next = _arena->cur->next;
+	_arena->cur->next = chunk;
+	_arena->cur = chunk;
+	return mem_arena__chunk_take(chunk, _size, _align);
+}
+
+void* mem_arena__zalloc(struct mem_arena *_arena, size_t _size, size_t _align)
+{
+	void *mem = mem_arena__alloc(_arena, _size, _align);
+
+	if (mem != NULL) {
+		memset(mem, 0, _size);
+	}
+	return mem;
+}
+
+int mem_arena__mark(struct mem_arena *_arena, struct mem_arena_mark *_mark)
+{
+	if ((_arena == NULL) || (_mark == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	_mark->chunk = _arena->cur;
+	_mark->used = _arena->cur->used;
+	return EOK;
+}
+
+int mem_arena__rewind(struct mem_arena *_arena, const struct mem_arena_mark *_mark)
+{
+	if ((_arena == NULL) || (_mark == NULL) || (_mark->chunk == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	_arena->cur = _mark->chunk;
+	_arena->cur->used = _mark->used;
+	return EOK;
+}
+
+int mem_arena__reset(struct mem_arena *_arena)
+{
+	if (_arena == NULL) {
+		return -EPAR_NULL;
+	}
+
+	_arena->cur = _arena->first;
+	_arena->cur->used = 0;
+	return EOK;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static struct mem_arena_chunk* mem_arena__chunk_new(size_t _size)
+{
+	struct mem_arena_chunk *chunk;
+
+	chunk = (struct mem_arena_chunk*)alloc_memory(1, MEM_ARENA__CHUNK_HDR + _size);
+	if (chunk == NULL) {
+		return NULL;
+	}
+	chunk->next = NULL;
+	chunk->size = _size;
+	chunk->used = 0;
+	return chunk;
+}
+
+static inline void* mem_arena__chunk_take(struct mem_arena_chunk *_chunk, size_t _size, size_t _align)
+{
+	uintptr_t base = (uintptr_t)_chunk + MEM_ARENA__CHUNK_HDR;
+	uintptr_t pos = base + _chunk->used;
+
+	pos = ALIGN(pos, _align);
+	if ((pos - base) > _chunk->size) {
+		return NULL;
+	}
+	if (_size > (_chunk->size - (pos - base))) {
+		return NULL;
+	}
+
+	_chunk->used = (pos - base) + _size;
+	return (void*)pos;
+}
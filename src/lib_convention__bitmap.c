@@ -0,0 +1,333 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* system */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+	#define BITMAP__X86
+	#include <immintrin.h>
+#endif
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__bitmap.h>
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Word kernels
+ *
+ * 	scan	: index of the first word in [_first, _last) which is not equal
+ * 			  to _skip, or _last if there is none
+ * 	count	: number of set bits of _count words
+ * ****************************************************************************/
+typedef size_t (*bitmap_scan_t)(const uint64_t *_words, size_t _first, size_t _last, uint64_t _skip);
+typedef size_t (*bitmap_count_t)(const uint64_t *_words, size_t _count);
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static size_t bitmap__find(const struct bitmap *_map, size_t _start, uint64_t _skip);
+static int bitmap__fill(struct bitmap *_map, size_t _first, size_t _count, uint64_t _value);
+static bitmap_scan_t bitmap__scan_kernel(void);
+static bitmap_count_t bitmap__count_kernel(void);
+static size_t bitmap__scan_generic(const uint64_t *_words, size_t _first, size_t _last, uint64_t _skip);
+static size_t bitmap__count_generic(const uint64_t *_words, size_t _count);
+#ifdef BITMAP__X86
+static size_t bitmap__scan_sse2(const uint64_t *_words, size_t _first, size_t _last, uint64_t _skip);
+static size_t bitmap__scan_avx2(const uint64_t *_words, size_t _first, size_t _last, uint64_t _skip);
+static size_t bitmap__count_popcnt(const uint64_t *_words, size_t _count);
+static size_t bitmap__count_avx2(const uint64_t *_words, size_t _count);
+#endif
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+
+/* kernels are selected on first use depending on the CPU features */
+static bitmap_scan_t s_scan;
+static bitmap_count_t s_count;
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int bitmap__init(struct bitmap *_map, uint64_t *_words, size_t _bits)
+{
+	if ((_map == NULL) || (_words == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	_map->words = _words;
+	_map->bits = _bits;
+	memset(_words, 0, BITMAP__WORDS(_bits) * sizeof(uint64_t));
+	return EOK;
+}
+
+int bitmap__set_range(struct bitmap *_map, size_t _first, size_t _count)
+{
+	return bitmap__fill(_map, _first, _count, ~0ULL);
+}
+
+int bitmap__clear_range(struct bitmap *_map, size_t _first, size_t _count)
+{
+	return bitmap__fill(_map, _first, _count, 0ULL);
+}
+
+size_t bitmap__find_first_set(const struct bitmap *_map, size_t _start)
+{
+	return bitmap__find(_map, _start, 0ULL);
+}
+
+size_t bitmap__find_first_clear(const struct bitmap *_map, size_t _start)
+{
+	return bitmap__find(_map, _start, ~0ULL);
+}
+
+size_t bitmap__count(const struct bitmap *_map)
+{
+	bitmap_count_t count = __atomic_load_n(&s_count, __ATOMIC_RELAXED);
+	size_t full = _map->bits / BITMAP__WORD_BITS;
+	size_t rest = _map->bits % BITMAP__WORD_BITS;
+	size_t n;
+
+	if (count == NULL) {
+		count = bitmap__count_kernel();
+		__atomic_store_n(&s_count, count, __ATOMIC_RELAXED);
+	}
+
+	n = count(_map->words, full);
+	if (rest != 0) {
+		n += bit__popcount64(_map->words[full] & BITMASK(rest));
+	}
+	return n;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static size_t bitmap__find(const struct bitmap *_map, size_t _start, uint64_t _skip)
+{
+	bitmap_scan_t scan = __atomic_load_n(&s_scan, __ATOMIC_RELAXED);
+	size_t words = BITMAP__WORDS(_map->bits);
+	size_t index, pos;
+	uint64_t word;
+
+	if (_start >= _map->bits) {
+		return _map->bits;
+	}
+	if (scan == NULL) {
+		scan = bitmap__scan_kernel();
+		__atomic_store_n(&s_scan, scan, __ATOMIC_RELAXED);
+	}
+
+	/* the first word is masked below the start bit, the remaining ones are scanned in bulk */
+	index = _start / BITMAP__WORD_BITS;
+	word = (_map->words[index] ^ _skip) & (~0ULL << (_start % BITMAP__WORD_BITS));
+	if (word == 0) {
+		index = scan(_map->words, index + 1, words, _skip);
+		if (index >= words) {
+			return _map->bits;
+		}
+		word = _map->words[index] ^ _skip;
+	}
+
+	/* the unused bits of the last word may match as well */
+	pos = (index * BITMAP__WORD_BITS) + bit__ctz64(word);
+	return (pos < _map->bits) ? pos : _map->bits;
+}
+
+static int bitmap__fill(struct bitmap *_map, size_t _first, size_t _count, uint64_t _value)
+{
+	size_t first_word, last_word;
+	uint64_t head, tail;
+
+	if (_map == NULL) {
+		return -EPAR_NULL;
+	}
+	if ((_first > _map->bits) || (_count > (_map->bits - _first))) {
+		return -EPAR_RANGE;
+	}
+	if (_count == 0) {
+		return EOK;
+	}
+
+	first_word = _first / BITMAP__WORD_BITS;
+	last_word = (_first + _count - 1) / BITMAP__WORD_BITS;
+	head = ~0ULL << (_first % BITMAP__WORD_BITS);
+	tail = ~0ULL >> ((BITMAP__WORD_BITS - 1) - ((_first + _count - 1) % BITMAP__WORD_BITS));
+
+	if (first_word == last_word) {
+		head &= tail;
+		_map->words[first_word] = (_map->words[first_word] & ~head) | (_value & head);
+		return EOK;
+	}
+
+	/* memset() already uses the widest stores of the target for the inner words */
+	_map->words[first_word] = (_map->words[first_word] & ~head) | (_value & head);
+	memset(&_map->words[first_word + 1], (int)(_value & 0xFFU), (last_word - first_word - 1) * sizeof(uint64_t));
+	_map->words[last_word] = (_map->words[last_word] & ~tail) | (_value & tail);
+	return EOK;
+}
+
+static bitmap_scan_t bitmap__scan_kernel(void)
+{
+#ifdef BITMAP__X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return bitmap__scan_avx2;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		return bitmap__scan_sse2;
+	}
+#endif
+	return bitmap__scan_generic;
+}
+
+static bitmap_count_t bitmap__count_kernel(void)
+{
+#ifdef BITMAP__X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return bitmap__count_avx2;
+	}
+	if (__builtin_cpu_supports("popcnt")) {
+		return bitmap__count_popcnt;
+	}
+#endif
+	return bitmap__count_generic;
+}
+
+static size_t bitmap__scan_generic(const uint64_t *_words, size_t _first, size_t _last, uint64_t _skip)
+{
+	while ((_first < _last) && (_words[_first] == _skip)) {
+		_first++;
+	}
+	return _first;
+}
+
+static size_t bitmap__count_generic(const uint64_t *_words, size_t _count)
+{
+	size_t i, n = 0;
+
+	for (i = 0; i < _count; i++) {
+		n += bit__popcount64(_words[i]);
+	}
+	return n;
+}
+
+#ifdef BITMAP__X86
+
+__attribute__((target("sse2")))
+static size_t bitmap__scan_sse2(const uint64_t *_words, size_t _first, size_t _last, uint64_t _skip)
+{
+	const __m128i skip = _mm_set1_epi64x((long long)_skip);
+	__m128i v0, v1, v2, v3;
+
+	/* 512 bits per iteration, the exact word is located by the generic loop */
+	while ((_first + 8) <= _last) {
+		v0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&_words[_first]), skip);
+		v1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&_words[_first + 2]), skip);
+		v2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&_words[_first + 4]), skip);
+		v3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&_words[_first + 6]), skip);
+		v0 = _mm_or_si128(_mm_or_si128(v0, v1), _mm_or_si128(v2, v3));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(v0, _mm_setzero_si128())) != 0xFFFF) {
+			break;
+		}
+		_first += 8;
+	}
+	return bitmap__scan_generic(_words, _first, _last, _skip);
+}
+
+__attribute__((target("avx2")))
+static size_t bitmap__scan_avx2(const uint64_t *_words, size_t _first, size_t _last, uint64_t _skip)
+{
+	const __m256i skip = _mm256_set1_epi64x((long long)_skip);
+	__m256i v0, v1, v2, v3;
+
+	/* 1024 bits per iteration */
+	while ((_first + 16) <= _last) {
+		v0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)&_words[_first]), skip);
+		v1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)&_words[_first + 4]), skip);
+		v2 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)&_words[_first + 8]), skip);
+		v3 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)&_words[_first + 12]), skip);
+		v0 = _mm256_or_si256(_mm256_or_si256(v0, v1), _mm256_or_si256(v2, v3));
+		if (!_mm256_testz_si256(v0, v0)) {
+			break;
+		}
+		_first += 16;
+	}
+	return bitmap__scan_generic(_words, _first, _last, _skip);
+}
+
+__attribute__((target("popcnt")))
+static size_t bitmap__count_popcnt(const uint64_t *_words, size_t _count)
+{
+	size_t i, n = 0;
+
+	for (i = 0; i < _count; i++) {
+		n += (size_t)__builtin_popcountll(_words[i]);
+	}
+	return n;
+}
+
+__attribute__((target("avx2")))
+static size_t bitmap__count_avx2(const uint64_t *_words, size_t _count)
+{
+	/* nibble lookup, the byte counts are summed up by the SAD instruction */
+	const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+											0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i low = _mm256_set1_epi8(0x0F);
+	__m256i acc = _mm256_setzero_si256();
+	__m256i v, cnt;
+	uint64_t lanes[4];
+	size_t i = 0, n;
+
+	for (; (i + 4) <= _count; i += 4) {
+		v = _mm256_loadu_si256((const __m256i*)&_words[i]);
+		cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low)),
+							  _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+		acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+	}
+
+	_mm256_storeu_si256((__m256i*)lanes, acc);
+	n = (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+	for (; i < _count; i++) {
+		n += bit__popcount64(_words[i]);
+	}
+	return n;
+}
+
+#endif /* BITMAP__X86 */
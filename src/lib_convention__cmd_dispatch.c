@@ -0,0 +1,192 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__cmd_dispatch.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* number of multipliers tried by cmd_dispatch__build() */
+#define CMD_DISPATCH__BUILD_TRIES	64U
+
+/* Fibonacci hashing, the upper bits of the product select the slot */
+#define CMD_DISPATCH__GOLDEN		0x9E3779B1U
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static inline uint32_t cmd_dispatch__slot(const struct cmd_dispatch *_disp, uint32_t _cmd);
+static void cmd_dispatch__clear(struct cmd_dispatch *_disp, uint32_t _mult);
+static int cmd_dispatch__insert(struct cmd_dispatch *_disp, uint32_t _cmd, cmd_dispatch_handler_t _handler, void *_ctx);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int cmd_dispatch__init(struct cmd_dispatch *_disp, struct cmd_dispatch_entry *_table, unsigned int _capacity)
+{
+	uint32_t bits;
+
+	if ((_disp == NULL) || (_table == NULL)) {
+		return -EPAR_NULL;
+	}
+	if (_capacity == 0) {
+		return -EPAR_RANGE;
+	}
+
+	bits = (uint32_t)bit__fls32((uint32_t)_capacity);
+	_disp->table = _table;
+	_disp->mask = (uint32_t)BITMASK(bits);
+	_disp->shift = 32U - bits;
+	cmd_dispatch__clear(_disp, CMD_DISPATCH__GOLDEN);
+	return EOK;
+}
+
+int cmd_dispatch__register(struct cmd_dispatch *_disp, uint32_t _cmd, cmd_dispatch_handler_t _handler, void *_ctx)
+{
+	if ((_disp == NULL) || (_handler == NULL)) {
+		return -EPAR_NULL;
+	}
+	return cmd_dispatch__insert(_disp, _cmd, _handler, _ctx);
+}
+
+int cmd_dispatch__build(struct cmd_dispatch *_disp, const struct cmd_dispatch_entry *_handlers, unsigned int _count)
+{
+	uint32_t mult, best_mult = CMD_DISPATCH__GOLDEN, best_probe = UINT32_MAX;
+	unsigned int i, attempt;
+	int ret;
+
+	if ((_disp == NULL) || (_handlers == NULL)) {
+		return -EPAR_NULL;
+	}
+	if (_count > (_disp->mask + 1U)) {
+		return -ELIST_OVERFLOW;
+	}
+
+	/* keep the multiplier with the shortest worst case probe sequence */
+	for (attempt = 0; (attempt < CMD_DISPATCH__BUILD_TRIES) && (best_probe > 1U); attempt++) {
+		mult = (CMD_DISPATCH__GOLDEN + (attempt * 0x3C6EF372U)) | 1U;
+		cmd_dispatch__clear(_disp, mult);
+		for (i = 0; i < _count; i++) {
+			ret = cmd_dispatch__register(_disp, _handlers[i].cmd, _handlers[i].handler, _handlers[i].ctx);
+			if (ret < EOK) {
+				cmd_dispatch__clear(_disp, CMD_DISPATCH__GOLDEN);
+				return ret;
+			}
+		}
+		if (_disp->max_probe < best_probe) {
+			best_probe = _disp->max_probe;
+			best_mult = mult;
+		}
+	}
+
+	if (_disp->mult != best_mult) {
+		cmd_dispatch__clear(_disp, best_mult);
+		for (i = 0; i < _count; i++) {
+			(void)cmd_dispatch__insert(_disp, _handlers[i].cmd, _handlers[i].handler, _handlers[i].ctx);
+		}
+	}
+	return EOK;
+}
+
+int cmd_dispatch__call(const struct cmd_dispatch *_disp, uint32_t _cmd, void *_arg, size_t _arg_size)
+{
+	const struct cmd_dispatch_entry *entry;
+	uint32_t slot, probe, key = CMD_DISPATCH__KEY(_cmd);
+
+	slot = cmd_dispatch__slot(_disp, _cmd);
+	for (probe = 0; probe < _disp->max_probe; probe++) {
+		entry = &_disp->table[(slot + probe) & _disp->mask];
+		if ((entry->handler != NULL) && (CMD_DISPATCH__KEY(entry->cmd) == key)) {
+			if (M_CONV__CMD__DIR(_cmd) != M_CONV__CMD__DIR(entry->cmd)) {
+				return -EPAR_OPNOTSUPP;
+			}
+			if ((M_CONV__CMD__SIZE(_cmd) != M_CONV__CMD__SIZE(entry->cmd)) ||
+				(_arg_size != (size_t)M_CONV__CMD__SIZE(entry->cmd))) {
+				return -ECOMM_BADLENGTH;
+			}
+			if ((_arg == NULL) && (_arg_size != 0)) {
+				return -EPAR_NULL;
+			}
+			return entry->handler(entry->ctx, _cmd, _arg);
+		}
+	}
+	return -EPAR_OPNOTSUPP;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static inline uint32_t cmd_dispatch__slot(const struct cmd_dispatch *_disp, uint32_t _cmd)
+{
+	/* shifted in 64 bit, a single slot table shifts by 32 */
+	return (uint32_t)((uint64_t)(CMD_DISPATCH__KEY(_cmd) * _disp->mult) >> _disp->shift);
+}
+
+static void cmd_dispatch__clear(struct cmd_dispatch *_disp, uint32_t _mult)
+{
+	memset(_disp->table, 0, (_disp->mask + 1U) * sizeof(struct cmd_dispatch_entry));
+	_disp->mult = _mult;
+	_disp->count = 0;
+	_disp->max_probe = 0;
+}
+
+static int cmd_dispatch__insert(struct cmd_dispatch *_disp, uint32_t _cmd, cmd_dispatch_handler_t _handler, void *_ctx)
+{
+	struct cmd_dispatch_entry *entry;
+	uint32_t slot, probe, key = CMD_DISPATCH__KEY(_cmd);
+
+	/* handlers are never removed, so the first free slot ends the probe sequence */
+	slot = cmd_dispatch__slot(_disp, _cmd);
+	for (probe = 0; probe <= _disp->mask; probe++) {
+		entry = &_disp->table[(slot + probe) & _disp->mask];
+		if (entry->handler == NULL) {
+			entry->cmd = _cmd;
+			entry->handler = _handler;
+			entry->ctx = _ctx;
+			_disp->count++;
+			if ((probe + 1U) > _disp->max_probe) {
+				_disp->max_probe = probe + 1U;
+			}
+			return EOK;
+		}
+		if (CMD_DISPATCH__KEY(entry->cmd) == key) {
+			return -ESTD_EXIST;
+		}
+	}
+	return -ELIST_OVERFLOW;
+}
@@ -0,0 +1,163 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__cmd_dispatch.h>
+#include <lib_convention__cmd_ring.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define CMD_RING__IS_POW2(_n)		(((_n) != 0) && (((_n) & ((_n) - 1U)) == 0))
+
+/* ring sizes are limited so that the free running indices never compare wrong */
+#define CMD_RING__MAX_ENTRIES		0x80000000U
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int cmd_ring__init(struct cmd_ring *_ring, struct cmd_ring_sqe *_sq, unsigned int _sq_entries,
+				   struct cmd_ring_cqe *_cq, unsigned int _cq_entries)
+{
+	if ((_ring == NULL) || (_sq == NULL) || (_cq == NULL)) {
+		return -EPAR_NULL;
+	}
+	if (!CMD_RING__IS_POW2(_sq_entries) || !CMD_RING__IS_POW2(_cq_entries) ||
+		(_sq_entries > CMD_RING__MAX_ENTRIES) || (_cq_entries > CMD_RING__MAX_ENTRIES)) {
+		return -EPAR_RANGE;
+	}
+
+	memset(_ring, 0, sizeof(*_ring));
+	_ring->sq = _sq;
+	_ring->cq = _cq;
+	_ring->sq_mask = _sq_entries - 1U;
+	_ring->cq_mask = _cq_entries - 1U;
+	return EOK;
+}
+
+int cmd_ring__prep(struct cmd_ring *_ring, uint32_t _cmd, void *_arg, uint32_t _arg_size, uint64_t _user_data)
+{
+	uint32_t prepared = _ring->sq_prepared;
+	struct cmd_ring_sqe *sqe;
+
+	if ((prepared - __atomic_load_n(&_ring->sq_head, __ATOMIC_ACQUIRE)) > _ring->sq_mask) {
+		return -ESTD_AGAIN;
+	}
+	/* a completion slot is reserved for every command in flight */
+	if ((prepared - _ring->cq_head) > _ring->cq_mask) {
+		return -ESTD_AGAIN;
+	}
+
+	sqe = &_ring->sq[prepared & _ring->sq_mask];
+	sqe->cmd = _cmd;
+	sqe->arg_size = _arg_size;
+	sqe->arg = _arg;
+	sqe->user_data = _user_data;
+	_ring->sq_prepared = prepared + 1U;
+	return EOK;
+}
+
+unsigned int cmd_ring__submit(struct cmd_ring *_ring)
+{
+	uint32_t count = _ring->sq_prepared - _ring->sq_tail;
+
+	__atomic_store_n(&_ring->sq_tail, _ring->sq_prepared, __ATOMIC_RELEASE);
+	return count;
+}
+
+unsigned int cmd_ring__reap(struct cmd_ring *_ring, struct cmd_ring_cqe *_cqes, unsigned int _max)
+{
+	uint32_t head = _ring->cq_head;
+	uint32_t avail = __atomic_load_n(&_ring->cq_tail, __ATOMIC_ACQUIRE) - head;
+	uint32_t i, n = (avail < _max) ? avail : _max;
+
+	for (i = 0; i < n; i++) {
+		_cqes[i] = _ring->cq[(head + i) & _ring->cq_mask];
+	}
+	/*
+	 * Only the capacity check of cmd_ring__prep() reads the head, the driver
+	 * never does: the reserved completion slots keep it from overrunning.
+	 */
+	_ring->cq_head = head + n;
+	return n;
+}
+
+unsigned int cmd_ring__consume(struct cmd_ring *_ring, struct cmd_ring_sqe *_sqes, unsigned int _max)
+{
+	uint32_t head = _ring->sq_head;
+	uint32_t avail = __atomic_load_n(&_ring->sq_tail, __ATOMIC_ACQUIRE) - head;
+	uint32_t i, n = (avail < _max) ? avail : _max;
+
+	for (i = 0; i < n; i++) {
+		_sqes[i] = _ring->sq[(head + i) & _ring->sq_mask];
+	}
+	__atomic_store_n(&_ring->sq_head, head + n, __ATOMIC_RELEASE);
+	return n;
+}
+
+void cmd_ring__complete(struct cmd_ring *_ring, const struct cmd_ring_sqe *_sqe, int _result)
+{
+	struct cmd_ring_cqe *cqe = &_ring->cq[_ring->cq_prepared & _ring->cq_mask];
+
+	cqe->user_data = _sqe->user_data;
+	cqe->cmd = _sqe->cmd;
+	cqe->result = _result;
+	_ring->cq_prepared++;
+}
+
+unsigned int cmd_ring__complete_submit(struct cmd_ring *_ring)
+{
+	uint32_t count = _ring->cq_prepared - _ring->cq_tail;
+
+	__atomic_store_n(&_ring->cq_tail, _ring->cq_prepared, __ATOMIC_RELEASE);
+	return count;
+}
+
+unsigned int cmd_ring__process(struct cmd_ring *_ring, const struct cmd_dispatch *_disp, unsigned int _max)
+{
+	uint32_t head = _ring->sq_head;
+	uint32_t avail = __atomic_load_n(&_ring->sq_tail, __ATOMIC_ACQUIRE) - head;
+	uint32_t i, n = (avail < _max) ? avail : _max;
+	const struct cmd_ring_sqe *sqe;
+
+	for (i = 0; i < n; i++) {
+		sqe = &_ring->sq[(head + i) & _ring->sq_mask];
+		cmd_ring__complete(_ring, sqe, cmd_dispatch__call(_disp, sqe->cmd, sqe->arg, sqe->arg_size));
+	}
+
+	/* the slots are handed back after the handlers have run */
+	__atomic_store_n(&_ring->sq_head, head + n, __ATOMIC_RELEASE);
+	(void)cmd_ring__complete_submit(_ring);
+	return n;
+}
@@ -0,0 +1,350 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* system */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+	#define CRC__X86
+	#include <immintrin.h>
+#endif
+
+/* own libs */
+#include <lib_convention__crc.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* bit reflected generator polynomials */
+#define CRC__POLY_CRC32			0xEDB88320U
+#define CRC__POLY_CRC32C		0x82F63B78U
+#define CRC__POLY_CRC16			0x8408U
+
+/* states of an engine */
+#define CRC__STATE_NONE			0U
+#define CRC__STATE_BUSY			1U
+#define CRC__STATE_READY		2U
+
+/* below this length the setup of the folding loop does not pay off */
+#define CRC__FOLD_MIN			64U
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+struct crc_engine;
+
+/* ************************************************************************//**
+ * \brief	Kernel, updates the raw CRC register without pre- and post-
+ * 			inversion
+ * ****************************************************************************/
+typedef uint32_t (*crc_kernel_t)(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len);
+
+/* ************************************************************************//**
+ * \brief	Tables and folding constants of a bit reflected CRC of up to 32 bits
+ *
+ * 	table[k][b] is the register after byte b followed by k zero bytes.
+ * 	fold holds x^(D+63) mod P and x^(D-1) mod P, bit reflected into 64 bits,
+ * 	for the folding distances D = 512 (fold[0], fold[1]) and D = 128
+ * 	(fold[2], fold[3]). Short messages and the tails left over by the
+ * 	folding kernel are passed to the tail kernel.
+ * ****************************************************************************/
+struct crc_engine {
+	uint32_t poly;
+	unsigned int width;
+	uint32_t state;
+	crc_kernel_t kernel;
+	crc_kernel_t tail;
+	uint64_t fold[4];
+	uint32_t table[8][256];
+};
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static uint32_t crc__update(struct crc_engine *_engine, uint32_t _crc, const void *_data, size_t _len);
+static void crc__setup(struct crc_engine *_engine);
+static uint64_t crc__xpow(const struct crc_engine *_engine, unsigned int _n);
+static uint32_t crc__bitwise(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len);
+static uint32_t crc__bytewise(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len);
+static uint32_t crc__slice8(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len);
+static inline uint32_t crc__load32(const uint8_t *_data);
+#ifdef CRC__X86
+static uint32_t crc__sse42(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len);
+static uint32_t crc__pclmul(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len);
+#endif
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+
+/* tables and kernels are set up on first use */
+static struct crc_engine s_crc32 = { CRC__POLY_CRC32, 32U, CRC__STATE_NONE, NULL, NULL, {0}, {{0}} };
+static struct crc_engine s_crc32c = { CRC__POLY_CRC32C, 32U, CRC__STATE_NONE, NULL, NULL, {0}, {{0}} };
+static struct crc_engine s_crc16 = { CRC__POLY_CRC16, 16U, CRC__STATE_NONE, NULL, NULL, {0}, {{0}} };
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+uint32_t crc__crc32(uint32_t _crc, const void *_data, size_t _len)
+{
+	return ~crc__update(&s_crc32, ~_crc, _data, _len);
+}
+
+uint32_t crc__crc32c(uint32_t _crc, const void *_data, size_t _len)
+{
+	return ~crc__update(&s_crc32c, ~_crc, _data, _len);
+}
+
+uint16_t crc__crc16(uint16_t _crc, const void *_data, size_t _len)
+{
+	return (uint16_t)~crc__update(&s_crc16, (uint16_t)~_crc, _data, _len);
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static uint32_t crc__update(struct crc_engine *_engine, uint32_t _crc, const void *_data, size_t _len)
+{
+	uint32_t state = __atomic_load_n(&_engine->state, __ATOMIC_ACQUIRE);
+
+	if ((_data == NULL) || (_len == 0)) {
+		return _crc;
+	}
+
+	if (state != CRC__STATE_READY) {
+		state = CRC__STATE_NONE;
+		if (!__atomic_compare_exchange_n(&_engine->state, &state, CRC__STATE_BUSY, 0,
+										 __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+			/* another context is building the tables, do not wait for it */
+			return (state == CRC__STATE_READY) ? _engine->kernel(_engine, _crc, (const uint8_t*)_data, _len)
+											   : crc__bitwise(_engine, _crc, (const uint8_t*)_data, _len);
+		}
+		crc__setup(_engine);
+		__atomic_store_n(&_engine->state, CRC__STATE_READY, __ATOMIC_RELEASE);
+	}
+
+	return _engine->kernel(_engine, _crc, (const uint8_t*)_data, _len);
+}
+
+static void crc__setup(struct crc_engine *_engine)
+{
+	unsigned int b, k;
+	uint32_t crc;
+	uint8_t byte;
+
+	for (b = 0; b < 256; b++) {
+		byte = (uint8_t)b;
+		_engine->table[0][b] = crc__bitwise(_engine, 0, &byte, 1);
+	}
+	for (k = 1; k < 8; k++) {
+		for (b = 0; b < 256; b++) {
+			crc = _engine->table[k - 1][b];
+			_engine->table[k][b] = (crc >> 8) ^ _engine->table[0][crc & 0xFFU];
+		}
+	}
+
+	_engine->fold[0] = crc__xpow(_engine, 512 + 63);
+	_engine->fold[1] = crc__xpow(_engine, 512 - 1);
+	_engine->fold[2] = crc__xpow(_engine, 128 + 63);
+	_engine->fold[3] = crc__xpow(_engine, 128 - 1);
+
+	_engine->tail = crc__slice8;
+#ifdef CRC__X86
+	/* folding outruns the latency bound crc32 instruction on bulk data */
+	__builtin_cpu_init();
+	if ((_engine->poly == CRC__POLY_CRC32C) && __builtin_cpu_supports("sse4.2")) {
+		_engine->tail = crc__sse42;
+	}
+	_engine->kernel = _engine->tail;
+	if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+		_engine->kernel = crc__pclmul;
+	}
+#else
+	_engine->kernel = _engine->tail;
+#endif
+}
+
+static uint64_t crc__xpow(const struct crc_engine *_engine, unsigned int _n)
+{
+	uint32_t poly = 0, rem = 1;
+	uint64_t reflected = 0;
+	unsigned int i;
+
+	/* x^_n mod P in normal bit order, P without its leading term */
+	for (i = 0; i < _engine->width; i++) {
+		poly |= ((_engine->poly >> i) & 1U) << (_engine->width - 1 - i);
+	}
+	for (i = 0; i < _n; i++) {
+		rem = (rem & (1U << (_engine->width - 1))) ? ((rem << 1) ^ poly) : (rem << 1);
+		if (_engine->width < 32) {
+			rem &= (1U << _engine->width) - 1;
+		}
+	}
+
+	/* coefficient of x^d goes to bit 63 - d */
+	for (i = 0; i < _engine->width; i++) {
+		reflected |= (uint64_t)((rem >> i) & 1U) << (63 - i);
+	}
+	return reflected;
+}
+
+static uint32_t crc__bitwise(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len)
+{
+	unsigned int i;
+
+	while (_len--) {
+		_crc ^= *_data++;
+		for (i = 0; i < 8; i++) {
+			_crc = (_crc >> 1) ^ (_engine->poly & (0U - (_crc & 1U)));
+		}
+	}
+	return _crc;
+}
+
+static uint32_t crc__bytewise(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len)
+{
+	while (_len--) {
+		_crc = (_crc >> 8) ^ _engine->table[0][(_crc ^ *_data++) & 0xFFU];
+	}
+	return _crc;
+}
+
+static uint32_t crc__slice8(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len)
+{
+	const uint32_t (*t)[256] = _engine->table;
+	uint32_t one, two;
+
+	/* the register of up to 32 bits is xored into the first four bytes */
+	while (_len >= 8) {
+		one = crc__load32(_data) ^ _crc;
+		two = crc__load32(_data + 4);
+		_crc = t[7][one & 0xFFU] ^ t[6][(one >> 8) & 0xFFU] ^ t[5][(one >> 16) & 0xFFU] ^ t[4][one >> 24] ^
+			   t[3][two & 0xFFU] ^ t[2][(two >> 8) & 0xFFU] ^ t[1][(two >> 16) & 0xFFU] ^ t[0][two >> 24];
+		_data += 8;
+		_len -= 8;
+	}
+	return crc__bytewise(_engine, _crc, _data, _len);
+}
+
+static inline uint32_t crc__load32(const uint8_t *_data)
+{
+	return (uint32_t)_data[0] | ((uint32_t)_data[1] << 8) | ((uint32_t)_data[2] << 16) | ((uint32_t)_data[3] << 24);
+}
+
+#ifdef CRC__X86
+
+__attribute__((target("sse4.2")))
+static uint32_t crc__sse42(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len)
+{
+#if defined(__x86_64__)
+	uint64_t crc = _crc, word;
+
+	while (_len >= 8) {
+		memcpy(&word, _data, sizeof(word));
+		crc = _mm_crc32_u64(crc, word);
+		_data += 8;
+		_len -= 8;
+	}
+	_crc = (uint32_t)crc;
+#endif
+	uint32_t half;
+
+	while (_len >= 4) {
+		memcpy(&half, _data, sizeof(half));
+		_crc = _mm_crc32_u32(_crc, half);
+		_data += 4;
+		_len -= 4;
+	}
+	while (_len--) {
+		_crc = _mm_crc32_u8(_crc, *_data++);
+	}
+	(void)_engine;
+	return _crc;
+}
+
+__attribute__((target("pclmul,sse4.1")))
+static uint32_t crc__pclmul(const struct crc_engine *_engine, uint32_t _crc, const uint8_t *_data, size_t _len)
+{
+	const __m128i k512 = _mm_set_epi64x((long long)_engine->fold[1], (long long)_engine->fold[0]);
+	const __m128i k128 = _mm_set_epi64x((long long)_engine->fold[3], (long long)_engine->fold[2]);
+	__m128i x0, x1, x2, x3;
+	uint8_t rest[16];
+
+	if (_len < CRC__FOLD_MIN) {
+		return _engine->tail(_engine, _crc, _data, _len);
+	}
+
+	/*
+	 * The message is reduced to 128 bits congruent to it modulo P, the
+	 * register enters as the first bits of the message. The low half of a
+	 * lane holds the earlier bits, it is moved by D + 64 bits, the high half
+	 * by D bits.
+	 */
+	x0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(const void*)_data), _mm_cvtsi32_si128((int)_crc));
+	x1 = _mm_loadu_si128((const __m128i*)(const void*)(_data + 16));
+	x2 = _mm_loadu_si128((const __m128i*)(const void*)(_data + 32));
+	x3 = _mm_loadu_si128((const __m128i*)(const void*)(_data + 48));
+	_data += 64;
+	_len -= 64;
+
+#define CRC__FOLD(_x, _k, _next)	\
+			_mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128((_x), (_k), 0x00), \
+										_mm_clmulepi64_si128((_x), (_k), 0x11)), (_next))
+
+	while (_len >= 64) {
+		x0 = CRC__FOLD(x0, k512, _mm_loadu_si128((const __m128i*)(const void*)_data));
+		x1 = CRC__FOLD(x1, k512, _mm_loadu_si128((const __m128i*)(const void*)(_data + 16)));
+		x2 = CRC__FOLD(x2, k512, _mm_loadu_si128((const __m128i*)(const void*)(_data + 32)));
+		x3 = CRC__FOLD(x3, k512, _mm_loadu_si128((const __m128i*)(const void*)(_data + 48)));
+		_data += 64;
+		_len -= 64;
+	}
+
+	x0 = CRC__FOLD(x0, k128, x1);
+	x0 = CRC__FOLD(x0, k128, x2);
+	x0 = CRC__FOLD(x0, k128, x3);
+	while (_len >= 16) {
+		x0 = CRC__FOLD(x0, k128, _mm_loadu_si128((const __m128i*)(const void*)_data));
+		_data += 16;
+		_len -= 16;
+	}
+
+#undef CRC__FOLD
+
+	/* the remainder is an ordinary message to a zero register */
+	_mm_storeu_si128((__m128i*)(void*)rest, x0);
+	_crc = _engine->tail(_engine, 0, rest, sizeof(rest));
+	return _engine->tail(_engine, _crc, _data, _len);
+}
+
+#endif /* CRC__X86 */
@@ -0,0 +1,316 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+
+/* project */
+#include "lib_convention__errno_table.h"
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Table entry of a custom code
+ *
+ * \param	_grp	: group of the code (ESTD, EPAR, ...)
+ * \param	_code	: custom code, its name is stored as string
+ * \param	_std	: closest standard errno value
+ * \param	_desc	: description returned by custom_strerror()
+ * ****************************************************************************/
+#define ERRNO__ENTRY(_grp, _code, _std, _desc)	\
+			[ERRNO__BASE_##_grp + ((_code) % 100)] = { (_code), (_std), #_code, (_desc) }
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+struct errno_entry {
+	int code;
+	int std;
+	const char *name;
+	const char *desc;
+};
+
+struct errno_group {
+	uint8_t base;
+	uint8_t len;
+};
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Standard to custom mapping used by convert_std_errno()
+ * ****************************************************************************/
+const uint16_t g_errno_std_map[] = {
+	/* "standard" error codes */
+	[EPERM]				= ESTD_PERM,
+	[ENOENT]			= ESTD_NOENT,
+	[ESRCH]				= ESTD_SRCH,
+	[EINTR]				= ESTD_INTR,
+	[EIO]				= ESTD_IO,
+	[ENXIO]				= ESTD_NXIO,
+	[E2BIG]				= ESTD_2BIG,
+	[ENOEXEC]			= ESTD_NOEXEC,
+	[EBADF]				= ESTD_BADF,
+	[ECHILD]			= ESTD_CHILD,
+	[EAGAIN]			= ESTD_AGAIN,
+	[ENOMEM]			= ESTD_NOMEM,
+	[EACCES]			= ESTD_ACCES,
+	[EFAULT]			= ESTD_FAULT,
+	[EBUSY]				= ESTD_BUSY,
+	[EEXIST]			= ESTD_EXIST,
+	[EXDEV]				= ESTD_XDEV,
+	[ENODEV]			= ESTD_NODEV,
+	[ENOTDIR]			= ESTD_NOTDIR,
+	[EISDIR]			= ESTD_ISDIR,
+	[EINVAL]			= ESTD_INVAL,
+	[ENFILE]			= ESTD_NFILE,
+	[EMFILE]			= ESTD_MFILE,
+	[ENOTTY]			= ESTD_NOTTY,
+	[EFBIG]				= ESTD_FBIG,
+	[ENOSPC]			= ESTD_NOSPC,
+	[ESPIPE]			= ESTD_SPIPE,
+	[EROFS]				= ESTD_ROFS,
+	[EMLINK]			= ESTD_MLINK,
+	[EPIPE]				= ESTD_PIPE,
+	[EDOM]				= ESTD_DOM,
+	[ERANGE]			= ESTD_RANGE,
+	[EDEADLK]			= EEXEC_DEADLK,
+	[ETIMEDOUT]			= EEXEC_TO,
+
+	/* epoll_ctl() */
+	[ELOOP]				= EPAR_COMBI,		// fd refers to an epoll instance and this EPOLL_CTL_ADD operation would result in a circular loop of epoll instances monitoring one another.
+
+	/* socket() */
+	[EAFNOSUPPORT]		= EPAR_INVCHTYPE,	// The implementation does not support the specified address family.
+	[ENOBUFS]			= ESTD_NOMEM,		// Insufficient memory is available. The socket cannot be created until sufficient resources are freed.
+	[EPROTONOSUPPORT]	= EPAR_INVCHN,		// The protocol type or the specified protocol is not supported within this domain.
+
+	/* bind() */
+	[EADDRINUSE]		= EPAR_OPNOTSUPP,	// The given address is already in use.
+	[ENOTSOCK]			= EPAR_INVCONFIGTYPE,	// The file descriptor sockfd does not refer to a socket.
+	[EADDRNOTAVAIL]		= EPAR_INVCONFIG,	// A nonexistent interface was requested or the requested address was not local.
+	[ENAMETOOLONG]		= EPAR_BADVALUE,	// addr is too long.
+
+	/* sendto() */
+	[ECONNRESET]		= ECOMM_CONDENIED,	// Connection reset by peer.
+	[EDESTADDRREQ]		= ECOMM_BADREQ,		// The socket is not connection-mode, and no peer address is set.
+	[EISCONN]			= ECOMM_ALRDYCON,	// The connection-mode socket was connected already but a recipient was specified.
+	[EMSGSIZE]			= ECOMM_BADLENGTH,	// The socket type requires that message be sent atomically, and the size of the message to be sent made this impossible.
+	[ENOTCONN]			= ECOMM_NOCON,		// The socket is not connected, and no target has been given.
+	[EOPNOTSUPP]		= EEXEC_OPNOTSUPP,	// Some bit in the flags argument is inappropriate for the socket type.
+
+	/* recvmmsg() */
+	[ECONNREFUSED]		= ECOMM_CONDENIED,	// A remote host refused to allow the network connection.
+
+	/* write() */
+	[EDQUOT]			= EPAR_RANGE,		// The user's quota of disk blocks on the filesystem containing the file referred to by fd has been exhausted.
+
+	/* get-/setsockopt() */
+	[ENOPROTOOPT]		= EPAR_INVVALUEID,	// The option is unknown at the level indicated.
+
+	/* open() */
+	[EOVERFLOW]			= EPAR_RANGE,		// pathname refers to a regular file that is too large to be opened.
+	[ETXTBSY]			= EPERM_RO,			// pathname refers to an executable image which is currently being executed and write access was requested.
+};
+
+const unsigned int g_errno_std_map_len = sizeof(g_errno_std_map) / sizeof(g_errno_std_map[0]);
+
+/* ************************************************************************//**
+ * \brief	Custom codes with their standard counterpart, name and description
+ * ****************************************************************************/
+static const struct errno_entry s_errno_table[ERRNO__TABLE_LEN] = {
+	ERRNO__ENTRY(ESTD, ESTD_PERM,			EPERM,			"Operation not permitted"),
+	ERRNO__ENTRY(ESTD, ESTD_NOENT,			ENOENT,			"No such file or directory"),
+	ERRNO__ENTRY(ESTD, ESTD_SRCH,			ESRCH,			"No such process"),
+	ERRNO__ENTRY(ESTD, ESTD_INTR,			EINTR,			"Interrupted function call"),
+	ERRNO__ENTRY(ESTD, ESTD_IO,				EIO,			"Input/output error"),
+	ERRNO__ENTRY(ESTD, ESTD_NXIO,			ENXIO,			"No such device or address"),
+	ERRNO__ENTRY(ESTD, ESTD_2BIG,			E2BIG,			"Arg list too long"),
+	ERRNO__ENTRY(ESTD, ESTD_NOEXEC,			ENOEXEC,		"Exec format error"),
+	ERRNO__ENTRY(ESTD, ESTD_BADF,			EBADF,			"Bad file descriptor"),
+	ERRNO__ENTRY(ESTD, ESTD_CHILD,			ECHILD,			"No child processes"),
+	ERRNO__ENTRY(ESTD, ESTD_AGAIN,			EAGAIN,			"Resource temporarily unavailable"),
+	ERRNO__ENTRY(ESTD, ESTD_NOMEM,			ENOMEM,			"Not enough space"),
+	ERRNO__ENTRY(ESTD, ESTD_ACCES,			EACCES,			"Permission denied"),
+	ERRNO__ENTRY(ESTD, ESTD_FAULT,			EFAULT,			"Bad address"),
+	ERRNO__ENTRY(ESTD, ESTD_BUSY,			EBUSY,			"Device or resource busy"),
+	ERRNO__ENTRY(ESTD, ESTD_EXIST,			EEXIST,			"File exists"),
+	ERRNO__ENTRY(ESTD, ESTD_XDEV,			EXDEV,			"Improper link"),
+	ERRNO__ENTRY(ESTD, ESTD_NODEV,			ENODEV,			"No such device"),
+	ERRNO__ENTRY(ESTD, ESTD_NOTDIR,			ENOTDIR,		"Not a directory"),
+	ERRNO__ENTRY(ESTD, ESTD_ISDIR,			EISDIR,			"Is a directory"),
+	ERRNO__ENTRY(ESTD, ESTD_INVAL,			EINVAL,			"Invalid argument"),
+	ERRNO__ENTRY(ESTD, ESTD_NFILE,			ENFILE,			"Too many open files in system"),
+	ERRNO__ENTRY(ESTD, ESTD_MFILE,			EMFILE,			"Too many open files"),
+	ERRNO__ENTRY(ESTD, ESTD_NOTTY,			ENOTTY,			"Inappropriate I/O control operation"),
+	ERRNO__ENTRY(ESTD, ESTD_FBIG,			EFBIG,			"File too large"),
+	ERRNO__ENTRY(ESTD, ESTD_NOSPC,			ENOSPC,			"No space left on device"),
+	ERRNO__ENTRY(ESTD, ESTD_SPIPE,			ESPIPE,			"Invalid seek"),
+	ERRNO__ENTRY(ESTD, ESTD_ROFS,			EROFS,			"Read-only file system"),
+	ERRNO__ENTRY(ESTD, ESTD_MLINK,			EMLINK,			"Too many links"),
+	ERRNO__ENTRY(ESTD, ESTD_PIPE,			EPIPE,			"Broken pipe"),
+	ERRNO__ENTRY(ESTD, ESTD_DOM,			EDOM,			"Domain error"),
+	ERRNO__ENTRY(ESTD, ESTD_RANGE,			ERANGE,			"Result too large"),
+
+	ERRNO__ENTRY(EPAR, EPAR_NULL,			EINVAL,			"NULL pointer passed as argument"),
+	ERRNO__ENTRY(EPAR, EPAR_RANGE,			ERANGE,			"Argument value out of allowed range"),
+	ERRNO__ENTRY(EPAR, EPAR_COMBI,			EINVAL,			"Argument value not supported by this configuration"),
+	ERRNO__ENTRY(EPAR, EPAR_INVCHN,			EPROTONOSUPPORT,"Channel invalid"),
+	ERRNO__ENTRY(EPAR, EPAR_INVCONFIG,		EINVAL,			"Configuration invalid"),
+	ERRNO__ENTRY(EPAR, EPAR_NOCONFIG,		EINVAL,			"Parameter not configured"),
+	ERRNO__ENTRY(EPAR, EPAR_INVIOTYPE,		EINVAL,			"Invalid IO type"),
+	ERRNO__ENTRY(EPAR, EPAR_INVCHTYPE,		EAFNOSUPPORT,	"Invalid channel type"),
+	ERRNO__ENTRY(EPAR, EPAR_INVVALUEID,		ENOPROTOOPT,	"Invalid value id"),
+	ERRNO__ENTRY(EPAR, EPAR_INVCONFIGTYPE,	ENOTSOCK,		"Invalid configuration type"),
+	ERRNO__ENTRY(EPAR, EPAR_OPNOTSUPP,		EOPNOTSUPP,		"Parameter operation not supported"),
+	ERRNO__ENTRY(EPAR, EPAR_BADVALUE,		EINVAL,			"Unexpected or invalid value"),
+
+	ERRNO__ENTRY(EEXEC, EEXEC_TO,			ETIMEDOUT,		"Execution timed out"),
+	ERRNO__ENTRY(EEXEC, EEXEC_NOINIT,		EINVAL,			"Component not (yet) initialized"),
+	ERRNO__ENTRY(EEXEC, EEXEC_AGAININIT,	EBUSY,			"Component already (still) initialized"),
+	ERRNO__ENTRY(EEXEC, EEXEC_FAILINIT,		EIO,			"Initialization of component failed"),
+	ERRNO__ENTRY(EEXEC, EEXEC_OPNOTSUPP,	EOPNOTSUPP,		"Operation not supported"),
+	ERRNO__ENTRY(EEXEC, EEXEC_DEADLK,		EDEADLK,		"Deadlock"),
+	ERRNO__ENTRY(EEXEC, EEXEC_CLEANUP,		EIO,			"Cleanup failed"),
+	ERRNO__ENTRY(EEXEC, EEXEC_INVCXT,		EPERM,			"Invalid thread context"),
+
+	ERRNO__ENTRY(EPERM, EPERM_RO,			EROFS,			"Resource is write-protected"),
+	ERRNO__ENTRY(EPERM, EPERM_WO,			EACCES,			"Resource is read-protected"),
+
+	ERRNO__ENTRY(ECOMM, ECOMM_CRC,			EIO,			"CRC error on data transmission"),
+	ERRNO__ENTRY(ECOMM, ECOMM_TO,			ETIMEDOUT,		"Communication timeout"),
+	ERRNO__ENTRY(ECOMM, ECOMM_CONDENIED,	ECONNREFUSED,	"Connection request denied"),
+	ERRNO__ENTRY(ECOMM, ECOMM_ALRDYCON,		EISCONN,		"Connection already active"),
+	ERRNO__ENTRY(ECOMM, ECOMM_NOCON,		ENOTCONN,		"Connection not active"),
+	ERRNO__ENTRY(ECOMM, ECOMM_BADLENGTH,	EMSGSIZE,		"Message length wrong"),
+	ERRNO__ENTRY(ECOMM, ECOMM_BADREQ,		EDESTADDRREQ,	"Message request wrong"),
+	ERRNO__ENTRY(ECOMM, ECOMM_BADCONTENT,	EIO,			"Message content wrong"),
+
+	ERRNO__ENTRY(ELIST, ELIST_OVERFLOW,		ENOBUFS,		"List overflow"),
+
+	ERRNO__ENTRY(EHAL, EHAL_ERROR,			EIO,			"HAL error"),
+};
+
+/* ************************************************************************//**
+ * \brief	Position of each group of hundreds inside of s_errno_table
+ * ****************************************************************************/
+static const struct errno_group s_errno_group[ERRNO__GROUP_COUNT] = {
+	[ESTD_PERM / 100 - ERRNO__GROUP_FIRST]		= { ERRNO__BASE_ESTD,	ERRNO__LEN_ESTD },
+	[EPAR_NULL / 100 - ERRNO__GROUP_FIRST]		= { ERRNO__BASE_EPAR,	ERRNO__LEN_EPAR },
+	[EEXEC_TO / 100 - ERRNO__GROUP_FIRST]		= { ERRNO__BASE_EEXEC,	ERRNO__LEN_EEXEC },
+	[EPERM_RO / 100 - ERRNO__GROUP_FIRST]		= { ERRNO__BASE_EPERM,	ERRNO__LEN_EPERM },
+	[ECOMM_CRC / 100 - ERRNO__GROUP_FIRST]		= { ERRNO__BASE_ECOMM,	ERRNO__LEN_ECOMM },
+	[ELIST_OVERFLOW / 100 - ERRNO__GROUP_FIRST]	= { ERRNO__BASE_ELIST,	ERRNO__LEN_ELIST },
+	[EHAL_ERROR / 100 - ERRNO__GROUP_FIRST]		= { ERRNO__BASE_EHAL,	ERRNO__LEN_EHAL },
+};
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static inline const struct errno_entry* errno__lookup(int _error_code);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int convert_custom_errno(int _error_code)
+{
+	const struct errno_entry *entry = errno__lookup(_error_code);
+
+	if (entry == NULL) {
+		return _error_code;
+	}
+	return (_error_code < 0) ? -entry->std : entry->std;
+}
+
+const char* custom_errno_name(int _error_code)
+{
+	const struct errno_entry *entry;
+
+	if (_error_code == EOK) {
+		return "EOK";
+	}
+	entry = errno__lookup(_error_code);
+	return (entry != NULL) ? entry->name : NULL;
+}
+
+const char* custom_strerror(int _error_code)
+{
+	const struct errno_entry *entry;
+
+	if (_error_code == EOK) {
+		return "Success";
+	}
+	entry = errno__lookup(_error_code);
+	return (entry != NULL) ? entry->desc : "Unknown error";
+}
+
+int errno__index(int _error_code)
+{
+	const struct errno_entry *entry = errno__lookup(_error_code);
+
+	return (entry != NULL) ? (int)(entry - s_errno_table) : -1;
+}
+
+int errno__code(unsigned int _index)
+{
+	return (_index < ERRNO__TABLE_LEN) ? s_errno_table[_index].code : 0;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static inline const struct errno_entry* errno__lookup(int _error_code)
+{
+	const struct errno_group *group;
+	unsigned int code, idx;
+
+	/* negated in unsigned, -INT_MIN overflows */
+	code = (_error_code < 0) ? (0U - (unsigned int)_error_code) : (unsigned int)_error_code;
+	idx = (code / 100) - ERRNO__GROUP_FIRST;
+	if (idx >= ERRNO__GROUP_COUNT) {
+		return NULL;
+	}
+
+	group = &s_errno_group[idx];
+	if ((code % 100) >= group->len) {
+		return NULL;
+	}
+
+	/* gaps in the numbering are left as empty entries */
+	idx = group->base + (code % 100);
+	return (s_errno_table[idx].name != NULL) ? &s_errno_table[idx] : NULL;
+}
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__ERRNO_TABLE_H_
+#define LIB_CONVENTION__ERRNO_TABLE_H_
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Layout of the custom code table
+ *
+ * 	Custom codes are grouped by hundreds (ESTD_ 10xx, EPAR_ 11xx, ...).
+ * 	Each group occupies a contiguous range of the table, so a code is
+ * 	found with one division by a constant and two array accesses.
+ * ****************************************************************************/
+#define ERRNO__GROUP_FIRST		10
+#define ERRNO__GROUP_COUNT		10
+
+#define ERRNO__LEN_ESTD			35
+#define ERRNO__LEN_EPAR			20
+#define ERRNO__LEN_EEXEC		8
+#define ERRNO__LEN_EPERM		2
+#define ERRNO__LEN_ECOMM		8
+#define ERRNO__LEN_ELIST		1
+#define ERRNO__LEN_EHAL			1
+
+#define ERRNO__BASE_ESTD		0
+#define ERRNO__BASE_EPAR		(ERRNO__BASE_ESTD  + ERRNO__LEN_ESTD)
+#define ERRNO__BASE_EEXEC		(ERRNO__BASE_EPAR  + ERRNO__LEN_EPAR)
+#define ERRNO__BASE_EPERM		(ERRNO__BASE_EEXEC + ERRNO__LEN_EEXEC)
+#define ERRNO__BASE_ECOMM		(ERRNO__BASE_EPERM + ERRNO__LEN_EPERM)
+#define ERRNO__BASE_ELIST		(ERRNO__BASE_ECOMM + ERRNO__LEN_ECOMM)
+#define ERRNO__BASE_EHAL		(ERRNO__BASE_ELIST + ERRNO__LEN_ELIST)
+#define ERRNO__TABLE_LEN		(ERRNO__BASE_EHAL  + ERRNO__LEN_EHAL)
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Position of a custom code inside of the code table
+ *
+ * \param	_error_code		Custom code, positive or negative
+ * \return	index in [0, ERRNO__TABLE_LEN), or -1 if _error_code is no custom code
+ * ****************************************************************************/
+int errno__index(int _error_code);
+
+/* ************************************************************************//**
+ * \brief	Custom code stored at a position of the code table
+ *
+ * \param	_index			Position inside of the code table
+ * \return	positive custom code, or 0 for unused positions
+ * ****************************************************************************/
+int errno__code(unsigned int _index);
+
+#endif /* LIB_CONVENTION__ERRNO_TABLE_H_ */
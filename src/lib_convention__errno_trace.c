@@ -0,0 +1,271 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <time.h>
+
+/* system */
+#include <pthread.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__errno_trace.h>
+#include <lib_convention__mem.h>
+
+/* project */
+#include "lib_convention__errno_table.h"
+
+#ifdef CONFIG__ERRNO_TRACE
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* counter slot of codes which are no custom codes */
+#define ERRNO_TRACE__SLOT_OTHER		ERRNO__TABLE_LEN
+#define ERRNO_TRACE__SLOTS			(ERRNO__TABLE_LEN + 1)
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Recording state of a single thread
+ *
+ * 	The ring is single producer (owning thread) / single consumer
+ * 	(errno_trace__drain()). Counters are only written by the owner and
+ * 	read with relaxed atomic loads. The state outlives its thread until
+ * 	the ring has been drained.
+ * ****************************************************************************/
+struct errno_trace_thread {
+	struct errno_trace_event ring[ERRNO_TRACE__RING_SIZE];
+	uint64_t counts[ERRNO_TRACE__SLOTS];
+	uint64_t dropped;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t id;
+	int exited;
+	struct errno_trace_thread *next;
+};
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+static __thread struct errno_trace_thread *s_thread;
+
+static pthread_mutex_t s_threads_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t s_threads_once = PTHREAD_ONCE_INIT;
+static pthread_key_t s_threads_key;
+static struct errno_trace_thread *s_threads;
+static uint32_t s_threads_id;
+
+/* counters of threads which exited and were drained */
+static uint64_t s_retired_counts[ERRNO_TRACE__SLOTS];
+static uint64_t s_retired_dropped;
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static void errno_trace__init(void);
+static void errno_trace__thread_exit(void *_arg);
+static struct errno_trace_thread* errno_trace__register(void);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+__attribute__((noinline)) int errno_trace__raise(int _error_code)
+{
+	struct errno_trace_thread *thread = s_thread;
+	struct errno_trace_event *event;
+	struct timespec ts;
+	uint32_t head;
+	int slot;
+
+	if (thread == NULL) {
+		thread = errno_trace__register();
+		if (thread == NULL) {
+			return _error_code;
+		}
+	}
+
+	slot = errno__index(_error_code);
+	if (slot < 0) {
+		slot = ERRNO_TRACE__SLOT_OTHER;
+	}
+	__atomic_store_n(&thread->counts[slot], thread->counts[slot] + 1, __ATOMIC_RELAXED);
+
+	/* never wait for the monitor, a full ring drops the event */
+	head = thread->head;
+	if ((head - __atomic_load_n(&thread->tail, __ATOMIC_ACQUIRE)) >= ERRNO_TRACE__RING_SIZE) {
+		__atomic_store_n(&thread->dropped, thread->dropped + 1, __ATOMIC_RELAXED);
+		return _error_code;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	event = &thread->ring[head & (ERRNO_TRACE__RING_SIZE - 1)];
+	event->code = _error_code;
+	event->thread = thread->id;
+	event->site = __builtin_return_address(0);
+	event->timestamp = ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+	__atomic_store_n(&thread->head, head + 1, __ATOMIC_RELEASE);
+
+	return _error_code;
+}
+
+int errno_trace__counters(struct errno_trace_count *_counts, unsigned int _max, uint64_t *_dropped)
+{
+	struct errno_trace_thread *thread;
+	uint64_t sum, dropped;
+	unsigned int slot, n = 0;
+
+	if (_counts == NULL) {
+		return -EPAR_NULL;
+	}
+
+	pthread_mutex_lock(&s_threads_lock);
+	for (slot = 0; (slot < ERRNO_TRACE__SLOTS) && (n < _max); slot++) {
+		sum = s_retired_counts[slot];
+		for (thread = s_threads; thread != NULL; thread = thread->next) {
+			sum += __atomic_load_n(&thread->counts[slot], __ATOMIC_RELAXED);
+		}
+		if (sum != 0) {
+			_counts[n].code = errno__code(slot);
+			_counts[n].count = sum;
+			n++;
+		}
+	}
+
+	dropped = s_retired_dropped;
+	for (thread = s_threads; thread != NULL; thread = thread->next) {
+		dropped += __atomic_load_n(&thread->dropped, __ATOMIC_RELAXED);
+	}
+	pthread_mutex_unlock(&s_threads_lock);
+
+	if (_dropped != NULL) {
+		*_dropped = dropped;
+	}
+	return (int)n;
+}
+
+int errno_trace__drain(struct errno_trace_event *_events, unsigned int _max)
+{
+	struct errno_trace_thread **link, *thread;
+	uint32_t head, tail;
+	unsigned int slot, n = 0;
+
+	if (_events == NULL) {
+		return -EPAR_NULL;
+	}
+
+	pthread_mutex_lock(&s_threads_lock);
+	link = &s_threads;
+	while ((thread = *link) != NULL) {
+		head = __atomic_load_n(&thread->head, __ATOMIC_ACQUIRE);
+		tail = thread->tail;
+		while ((tail != head) && (n < _max)) {
+			_events[n++] = thread->ring[tail & (ERRNO_TRACE__RING_SIZE - 1)];
+			tail++;
+		}
+		__atomic_store_n(&thread->tail, tail, __ATOMIC_RELEASE);
+
+		/* retire the state of finished threads once nothing is left to read */
+		if (__atomic_load_n(&thread->exited, __ATOMIC_ACQUIRE) && (tail == head)) {
+			for (slot = 0; slot < ERRNO_TRACE__SLOTS; slot++) {
+				s_retired_counts[slot] += thread->counts[slot];
+			}
+			s_retired_dropped += thread->dropped;
+			*link = thread->next;
+			free_memory(thread);
+			continue;
+		}
+		link = &thread->next;
+	}
+	pthread_mutex_unlock(&s_threads_lock);
+
+	return (int)n;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static void errno_trace__init(void)
+{
+	pthread_key_create(&s_threads_key, errno_trace__thread_exit);
+}
+
+static void errno_trace__thread_exit(void *_arg)
+{
+	struct errno_trace_thread *thread = (struct errno_trace_thread*)_arg;
+
+	s_thread = NULL;
+	__atomic_store_n(&thread->exited, 1, __ATOMIC_RELEASE);
+}
+
+static struct errno_trace_thread* errno_trace__register(void)
+{
+	struct errno_trace_thread *thread;
+
+	pthread_once(&s_threads_once, errno_trace__init);
+
+	thread = (struct errno_trace_thread*)alloc_memory(1, sizeof(struct errno_trace_thread));
+	if (thread == NULL) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&s_threads_lock);
+	thread->id = s_threads_id++;
+	thread->next = s_threads;
+	s_threads = thread;
+	pthread_mutex_unlock(&s_threads_lock);
+
+	pthread_setspecific(s_threads_key, thread);
+	s_thread = thread;
+	return thread;
+}
+
+#else /* CONFIG__ERRNO_TRACE */
+
+int errno_trace__counters(struct errno_trace_count *_counts, unsigned int _max, uint64_t *_dropped)
+{
+	(void)_counts;
+	(void)_max;
+	(void)_dropped;
+	return -EEXEC_OPNOTSUPP;
+}
+
+int errno_trace__drain(struct errno_trace_event *_events, unsigned int _max)
+{
+	(void)_events;
+	(void)_max;
+	return -EEXEC_OPNOTSUPP;
+}
+
+#endif /* CONFIG__ERRNO_TRACE */
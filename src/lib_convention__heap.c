@@ -0,0 +1,593 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* system */
+#ifdef CONFIG__FREERTOS_ALLOC
+	#include <FreeRTOS.h>
+	#include <task.h>
+#else
+	#include <pthread.h>
+#endif
+
+#if defined(CONFIG__UNIX_ALLOC) && defined(__linux__)
+	#include <unistd.h>
+	#include <sys/syscall.h>
+#endif
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__mem.h>
+#include <lib_convention__ilist.h>
+#include <lib_convention__pool.h>
+#include <lib_convention__heap.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define HEAP__CHUNK_HDR		ALIGN(sizeof(struct heap_chunk), HEAP__ALIGN)
+#define HEAP__BLOCK_HDR		ALIGN(sizeof(struct heap_block), HEAP__ALIGN)
+#define HEAP__HDR_SIZE		ALIGN(sizeof(struct heap_hdr), HEAP__ALIGN)
+
+/* size classes of the SEGREGATED backend, 32 bytes up to HEAP__SEGREGATED_MAX */
+#define HEAP__CLASS_MIN_SHIFT	5U
+#define HEAP__CLASSES			8U
+#define HEAP__CLASS_LARGE		UINT32_MAX
+
+/* memory policies of mbind(2), <numaif.h> is part of libnuma and not needed */
+#if defined(CONFIG__UNIX_ALLOC) && defined(__linux__) && defined(SYS_mbind)
+	#define HEAP__NUMA
+	#define HEAP__MPOL_DEFAULT		0
+	#define HEAP__MPOL_PREFERRED	1
+	#define HEAP__MPOL_MF_MOVE		(1U << 1)
+#endif
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* Private chunk of the ARENA and SEGREGATED backends, used counts from the chunk start */
+struct heap_chunk {
+	struct heap_chunk *next;
+	size_t size;
+	size_t used;
+};
+
+/* Tracked block of the SYSTEM backend or large block of the SEGREGATED backend */
+struct heap_block {
+	struct ilist_node node;
+	size_t size;
+};
+
+/* Header in front of a SEGREGATED block, next links the block while it is free */
+struct heap_hdr {
+	struct heap_hdr *next;
+	uint32_t cls;
+};
+
+struct heap {
+	enum heap_backend backend;
+	unsigned int flags;
+	int node;
+	const char *name;
+	size_t chunk_size;
+	struct heap_chunk *first;
+	struct heap_chunk *cur;
+	struct heap_hdr *free[HEAP__CLASSES];
+	struct ilist blocks;
+	struct mem_pool pool;
+	void *region;
+	size_t region_size;
+	size_t block_size;
+	struct heap_stats stats;
+#ifndef CONFIG__FREERTOS_ALLOC
+	pthread_mutex_t lock;
+#endif
+};
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static inline void heap__lock(struct heap *_heap);
+static inline void heap__unlock(struct heap *_heap);
+static void heap__bind(const struct heap *_heap, void *_mem, size_t _size, int _node);
+static void* heap__map(struct heap *_heap, size_t _size);
+static void heap__unmap(struct heap *_heap, void *_mem, size_t _size);
+static void* heap__bump(struct heap *_heap, size_t _size);
+static void heap__drop(struct heap *_heap);
+static int heap__pool_init(struct heap *_heap);
+static void* heap__alloc_system(struct heap *_heap, size_t _size);
+static void* heap__alloc_large(struct heap *_heap, size_t _size);
+static void* heap__alloc_segregated(struct heap *_heap, size_t _size);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int heap__create(struct heap **_heap, const struct heap_config *_config)
+{
+	struct heap *heap;
+	int ret;
+
+	if ((_heap == NULL) || (_config == NULL)) {
+		return -EPAR_NULL;
+	}
+	if ((_config->backend > HEAP__BACKEND_POOL) ||
+		(_config->node < HEAP__NODE_ANY) || (_config->node >= (int)(sizeof(unsigned long) * 8))) {
+		return -EPAR_RANGE;
+	}
+	if ((_config->backend == HEAP__BACKEND_POOL) &&
+		((_config->block_size == 0) || (_config->blocks == 0) ||
+		 (_config->block_size > ((SIZE_MAX / 2) / _config->blocks)))) {
+		return -EPAR_RANGE;
+	}
+
+	heap = (struct heap*)alloc_memory(1, sizeof(struct heap));
+	if (heap == NULL) {
+		return -ESTD_NOMEM;
+	}
+	heap->backend = _config->backend;
+	heap->flags = _config->flags;
+	heap->node = _config->node;
+	heap->name = _config->name;
+	heap->chunk_size = (_config->chunk_size != 0) ? _config->chunk_size : HEAP__DEFAULT_CHUNK_SIZE;
+	heap->block_size = _config->block_size;
+	ilist__init(&heap->blocks);
+
+	if (heap->backend == HEAP__BACKEND_POOL) {
+		heap->region_size = MEM_POOL__BUFFER_SIZE(ALIGN(heap->block_size, HEAP__ALIGN), _config->blocks) + HEAP__ALIGN;
+		heap->region = heap__map(heap, heap->region_size);
+		if (heap->region == NULL) {
+			free_memory(heap);
+			return -ESTD_NOMEM;
+		}
+		ret = heap__pool_init(heap);
+		if (ret < EOK) {
+			heap__unmap(heap, heap->region, heap->region_size);
+			free_memory(heap);
+			return ret;
+		}
+	}
+
+#ifndef CONFIG__FREERTOS_ALLOC
+	if (heap->flags & HEAP__FLAG_SHARED) {
+		pthread_mutex_init(&heap->lock, NULL);
+	}
+#endif
+
+	*_heap = heap;
+	return EOK;
+}
+
+int heap__destroy(struct heap **_heap)
+{
+	struct heap *heap;
+	struct heap_chunk *chunk, *next;
+
+	if ((_heap == NULL) || (*_heap == NULL)) {
+		return -EPAR_NULL;
+	}
+	heap = *_heap;
+
+	heap__drop(heap);
+	for (chunk = heap->first; chunk != NULL; chunk = next) {
+		next = chunk->next;
+		heap__unmap(heap, chunk, chunk->size);
+	}
+	if (heap->region != NULL) {
+		heap__unmap(heap, heap->region, heap->region_size);
+	}
+
+#ifndef CONFIG__FREERTOS_ALLOC
+	if (heap->flags & HEAP__FLAG_SHARED) {
+		pthread_mutex_destroy(&heap->lock);
+	}
+#endif
+	free_memory(heap);
+	*_heap = NULL;
+	return EOK;
+}
+
+int heap__reset(struct heap *_heap)
+{
+	struct heap_chunk *chunk;
+
+	if (_heap == NULL) {
+		return -EPAR_NULL;
+	}
+
+	heap__lock(_heap);
+	heap__drop(_heap);
+	for (chunk = _heap->first; chunk != NULL; chunk = chunk->next) {
+		chunk->used = HEAP__CHUNK_HDR;
+	}
+	_heap->cur = _heap->first;
+	memset(_heap->free, 0, sizeof(_heap->free));
+	if (_heap->backend == HEAP__BACKEND_POOL) {
+		heap__pool_init(_heap);
+	}
+	__atomic_store_n(&_heap->stats.live_blocks, 0, __ATOMIC_RELAXED);
+	heap__unlock(_heap);
+	return EOK;
+}
+
+void* heap__alloc(struct heap *_heap, size_t _size)
+{
+	void *mem = NULL;
+
+	if (_heap == NULL) {
+		return alloc_memory(1, _size);
+	}
+
+	switch (_heap->backend) {
+		case HEAP__BACKEND_SYSTEM:
+			return heap__alloc_system(_heap, _size);
+		case HEAP__BACKEND_ARENA:
+			if (_size > (SIZE_MAX / 2)) {
+				return NULL;
+			}
+			heap__lock(_heap);
+			mem = heap__bump(_heap, ALIGN(_size, HEAP__ALIGN));
+			if (mem != NULL) {
+				_heap->stats.live_blocks++;
+			}
+			heap__unlock(_heap);
+			break;
+		case HEAP__BACKEND_SEGREGATED:
+			if (_size > (HEAP__SEGREGATED_MAX - HEAP__HDR_SIZE)) {
+				return heap__alloc_large(_heap, _size);
+			}
+			mem = heap__alloc_segregated(_heap, _size);
+			break;
+		case HEAP__BACKEND_POOL:
+			/* the pool is lock-free if the heap is shared */
+			if (_size > _heap->block_size) {
+				return NULL;
+			}
+			mem = mem_pool__alloc(&_heap->pool);
+			if (mem != NULL) {
+				__atomic_add_fetch(&_heap->stats.live_blocks, 1, __ATOMIC_RELAXED);
+			}
+			break;
+	}
+
+	if (mem != NULL) {
+		memset(mem, 0, _size);
+	}
+	return mem;
+}
+
+void heap__free(struct heap *_heap, void *_mem)
+{
+	struct heap_block *blk;
+	struct heap_hdr *hdr;
+
+	if (_heap == NULL) {
+		free_memory(_mem);
+		return;
+	}
+	if (_mem == NULL) {
+		return;
+	}
+
+	switch (_heap->backend) {
+		case HEAP__BACKEND_SYSTEM:
+			blk = (struct heap_block*)((char*)_mem - HEAP__BLOCK_HDR);
+			heap__lock(_heap);
+			ilist__remove(&blk->node);
+			_heap->stats.reserved_bytes -= blk->size;
+			_heap->stats.live_blocks--;
+			heap__unlock(_heap);
+			free_memory(blk);
+			break;
+		case HEAP__BACKEND_ARENA:
+			/* the memory is reclaimed by heap__reset() */
+			heap__lock(_heap);
+			_heap->stats.live_blocks--;
+			heap__unlock(_heap);
+			break;
+		case HEAP__BACKEND_SEGREGATED:
+			hdr = (struct heap_hdr*)((char*)_mem - HEAP__HDR_SIZE);
+			if (hdr->cls == HEAP__CLASS_LARGE) {
+				blk = (struct heap_block*)((char*)hdr - HEAP__BLOCK_HDR);
+				heap__lock(_heap);
+				ilist__remove(&blk->node);
+				_heap->stats.live_blocks--;
+				heap__unmap(_heap, blk, blk->size);
+				heap__unlock(_heap);
+				break;
+			}
+			heap__lock(_heap);
+			hdr->next = _heap->free[hdr->cls];
+			_heap->free[hdr->cls] = hdr;
+			_heap->stats.live_blocks--;
+			heap__unlock(_heap);
+			break;
+		case HEAP__BACKEND_POOL:
+			if (mem_pool__free(&_heap->pool, _mem) == EOK) {
+				__atomic_sub_fetch(&_heap->stats.live_blocks, 1, __ATOMIC_RELAXED);
+			}
+			break;
+	}
+}
+
+int heap__stats(const struct heap *_heap, struct heap_stats *_stats)
+{
+	struct heap *heap = (struct heap*)_heap;
+
+	if ((_heap == NULL) || (_stats == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	heap__lock(heap);
+	_stats->reserved_bytes = heap->stats.reserved_bytes;
+	_stats->live_blocks = __atomic_load_n(&heap->stats.live_blocks, __ATOMIC_RELAXED);
+	heap__unlock(heap);
+	return EOK;
+}
+
+const char* heap__name(const struct heap *_heap)
+{
+	if (_heap == NULL) {
+		return "default";
+	}
+	return (_heap->name != NULL) ? _heap->name : "anonymous";
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static inline void heap__lock(struct heap *_heap)
+{
+	if (!(_heap->flags & HEAP__FLAG_SHARED)) {
+		return;
+	}
+#ifdef CONFIG__FREERTOS_ALLOC
+	vTaskSuspendAll();
+#else
+	pthread_mutex_lock(&_heap->lock);
+#endif
+}
+
+static inline void heap__unlock(struct heap *_heap)
+{
+	if (!(_heap->flags & HEAP__FLAG_SHARED)) {
+		return;
+	}
+#ifdef CONFIG__FREERTOS_ALLOC
+	(void)xTaskResumeAll();
+#else
+	pthread_mutex_unlock(&_heap->lock);
+#endif
+}
+
+static void heap__bind(const struct heap *_heap, void *_mem, size_t _size, int _node)
+{
+#ifdef HEAP__NUMA
+	unsigned long mask;
+
+	/* a failing mbind() leaves the default placement, which is still correct */
+	if (_heap->node == HEAP__NODE_ANY) {
+		return;
+	}
+	if (_node == HEAP__NODE_ANY) {
+		(void)syscall(SYS_mbind, _mem, _size, HEAP__MPOL_DEFAULT, NULL, 0UL, 0U);
+		return;
+	}
+	mask = 1UL << _node;
+	(void)syscall(SYS_mbind, _mem, _size, HEAP__MPOL_PREFERRED, &mask, sizeof(mask) * 8, HEAP__MPOL_MF_MOVE);
+#else
+	(void)_heap;
+	(void)_mem;
+	(void)_size;
+	(void)_node;
+#endif
+}
+
+static void* heap__map(struct heap *_heap, size_t _size)
+{
+	void *mem;
+
+	/* dedicated page aligned mappings on unix, so the node policy covers nothing else */
+	mem = alloc_memory_large(_size);
+	if (mem == NULL) {
+		return NULL;
+	}
+	heap__bind(_heap, mem, _size, _heap->node);
+	_heap->stats.reserved_bytes += _size;
+	return mem;
+}
+
+static void heap__unmap(struct heap *_heap, void *_mem, size_t _size)
+{
+	/* released mappings may be reused by anybody, drop the node policy */
+	heap__bind(_heap, _mem, _size, HEAP__NODE_ANY);
+	_heap->stats.reserved_bytes -= _size;
+	free_memory_large(_mem);
+}
+
+static void* heap__bump(struct heap *_heap, size_t _size)
+{
+	struct heap_chunk *chunk = _heap->cur;
+	size_t start = 0;
+	size_t size;
+
+	if (chunk != NULL) {
+		start = ALIGN((uintptr_t)chunk + chunk->used, (uintptr_t)HEAP__ALIGN) - (uintptr_t)chunk;
+		if ((start + _size) > chunk->size) {
+			chunk = chunk->next;
+			if (chunk != NULL) {
+				/* continue with a chunk kept from before the last reset */
+				start = ALIGN((uintptr_t)chunk + chunk->used, (uintptr_t)HEAP__ALIGN) - (uintptr_t)chunk;
+				if ((start + _size) > chunk->size) {
+					chunk = NULL;
+				}
+			}
+		}
+	}
+
+	if (chunk == NULL) {
+		size = HEAP__CHUNK_HDR + _size + HEAP__ALIGN;
+		if (size < _heap->chunk_size) {
+			size = _heap->chunk_size;
+		}
+		chunk = (struct heap_chunk*)heap__map(_heap, size);
+		if (chunk == NULL) {
+			return NULL;
+		}
+		chunk->size = size;
+		chunk->used = HEAP__CHUNK_HDR;
+		if (_heap->cur == NULL) {
+			chunk->next = NULL;
+			_heap->first = chunk;
+		}
+		else {
+			chunk->next = _heap->cur->next;
+			_heap->cur->next = chunk;
+		}
+		start = ALIGN((uintptr_t)chunk + chunk->used, (uintptr_t)HEAP__ALIGN) - (uintptr_t)chunk;
+	}
+
+	_heap->cur = chunk;
+	chunk->used = start + _size;
+	return (char*)chunk + start;
+}
+
+static void heap__drop(struct heap *_heap)
+{
+	struct ilist_node *node, *tmp;
+	struct heap_block *blk;
+
+	ILIST__FOREACH_SAFE(&_heap->blocks, node, tmp) {
+		blk = ILIST__ENTRY(node, struct heap_block, node);
+		ilist__remove(node);
+		if (_heap->backend == HEAP__BACKEND_SYSTEM) {
+			_heap->stats.reserved_bytes -= blk->size;
+			free_memory(blk);
+		}
+		else {
+			heap__unmap(_heap, blk, blk->size);
+		}
+	}
+}
+
+static int heap__pool_init(struct heap *_heap)
+{
+	uintptr_t base = ALIGN((uintptr_t)_heap->region, (uintptr_t)HEAP__ALIGN);
+
+	return mem_pool__init(&_heap->pool, (void*)base, _heap->region_size - HEAP__ALIGN,
+						  ALIGN(_heap->block_size, HEAP__ALIGN),
+						  (unsigned int)((_heap->region_size - HEAP__ALIGN) / ALIGN(_heap->block_size, HEAP__ALIGN)),
+						  (_heap->flags & HEAP__FLAG_SHARED) ? MEM_POOL__FLAG_LOCKFREE : MEM_POOL__FLAG_NONE);
+}
+
+static void* heap__alloc_system(struct heap *_heap, size_t _size)
+{
+	struct heap_block *blk;
+
+	if (_size > (SIZE_MAX - HEAP__BLOCK_HDR)) {
+		return NULL;
+	}
+	blk = (struct heap_block*)alloc_memory(1, HEAP__BLOCK_HDR + _size);
+	if (blk == NULL) {
+		return NULL;
+	}
+	blk->size = HEAP__BLOCK_HDR + _size;
+
+	heap__lock(_heap);
+	ilist__push_back(&_heap->blocks, &blk->node);
+	_heap->stats.reserved_bytes += blk->size;
+	_heap->stats.live_blocks++;
+	heap__unlock(_heap);
+	return (char*)blk + HEAP__BLOCK_HDR;
+}
+
+static void* heap__alloc_large(struct heap *_heap, size_t _size)
+{
+	struct heap_block *blk;
+	struct heap_hdr *hdr;
+	size_t size;
+
+	if (_size > (SIZE_MAX / 2)) {
+		return NULL;
+	}
+	size = HEAP__BLOCK_HDR + HEAP__HDR_SIZE + _size;
+
+	/* the large block is mapped on its own and returned to the system by heap__free() */
+	heap__lock(_heap);
+	blk = (struct heap_block*)heap__map(_heap, size);
+	if (blk != NULL) {
+		blk->size = size;
+		ilist__push_back(&_heap->blocks, &blk->node);
+		_heap->stats.live_blocks++;
+	}
+	heap__unlock(_heap);
+	if (blk == NULL) {
+		return NULL;
+	}
+
+	hdr = (struct heap_hdr*)((char*)blk + HEAP__BLOCK_HDR);
+	hdr->next = NULL;
+	hdr->cls = HEAP__CLASS_LARGE;
+	return (char*)hdr + HEAP__HDR_SIZE;
+}
+
+static void* heap__alloc_segregated(struct heap *_heap, size_t _size)
+{
+	struct heap_hdr *hdr;
+	uint32_t cls;
+
+	cls = 32U - (uint32_t)__builtin_clz((uint32_t)(_size + HEAP__HDR_SIZE - 1) | 1U);
+	cls = (cls > HEAP__CLASS_MIN_SHIFT) ? (cls - HEAP__CLASS_MIN_SHIFT) : 0;
+
+	heap__lock(_heap);
+	hdr = _heap->free[cls];
+	if (hdr != NULL) {
+		_heap->free[cls] = hdr->next;
+	}
+	else {
+		hdr = (struct heap_hdr*)heap__bump(_heap, (size_t)1 << (cls + HEAP__CLASS_MIN_SHIFT));
+	}
+	if (hdr != NULL) {
+		_heap->stats.live_blocks++;
+	}
+	heap__unlock(_heap);
+	if (hdr == NULL) {
+		return NULL;
+	}
+
+	hdr->next = NULL;
+	hdr->cls = cls;
+	return (char*)hdr + HEAP__HDR_SIZE;
+}
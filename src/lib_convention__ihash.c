@@ -0,0 +1,136 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__ihash.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define IHASH__IS_POW2(_n)		(((_n) != 0) && (((_n) & ((_n) - 1U)) == 0))
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int ihash__init(struct ihash *_table, struct ihash_slot *_slots, unsigned int _capacity, ihash_equal_t _equal)
+{
+	if ((_table == NULL) || (_slots == NULL) || (_equal == NULL)) {
+		return -EPAR_NULL;
+	}
+	if (!IHASH__IS_POW2(_capacity) || (_capacity < 2U) || (_capacity > 0x80000000U)) {
+		return -EPAR_RANGE;
+	}
+
+	memset(_slots, 0, _capacity * sizeof(struct ihash_slot));
+	_table->slots = _slots;
+	_table->mask = _capacity - 1U;
+	_table->count = 0;
+	_table->equal = _equal;
+	return EOK;
+}
+
+int ihash__insert(struct ihash *_table, struct ihash_node *_node, uint32_t _hash, const void *_key)
+{
+	struct ihash_slot *slot;
+	uint32_t idx;
+
+	if (_node == NULL) {
+		return -EPAR_NULL;
+	}
+	/* a free slot ends every probe sequence */
+	if (_table->count >= _table->mask) {
+		return -ELIST_OVERFLOW;
+	}
+
+	for (idx = _hash & _table->mask; ; idx = (idx + 1U) & _table->mask) {
+		slot = &_table->slots[idx];
+		if (slot->node == NULL) {
+			break;
+		}
+		if ((slot->hash == _hash) && _table->equal(slot->node, _key)) {
+			return -ESTD_EXIST;
+		}
+	}
+
+	_node->hash = _hash;
+	slot->hash = _hash;
+	slot->node = _node;
+	_table->count++;
+	return EOK;
+}
+
+struct ihash_node* ihash__find(const struct ihash *_table, uint32_t _hash, const void *_key)
+{
+	const struct ihash_slot *slot;
+	uint32_t idx;
+
+	for (idx = _hash & _table->mask; ; idx = (idx + 1U) & _table->mask) {
+		slot = &_table->slots[idx];
+		if (slot->node == NULL) {
+			return NULL;
+		}
+		if ((slot->hash == _hash) && _table->equal(slot->node, _key)) {
+			return slot->node;
+		}
+	}
+}
+
+int ihash__remove(struct ihash *_table, struct ihash_node *_node)
+{
+	uint32_t idx, next, home;
+
+	if (_node == NULL) {
+		return -EPAR_NULL;
+	}
+
+	for (idx = _node->hash & _table->mask; _table->slots[idx].node != _node; idx = (idx + 1U) & _table->mask) {
+		if (_table->slots[idx].node == NULL) {
+			return -ESTD_NOENT;
+		}
+	}
+
+	/* shift back every following entry whose home slot is not between the hole and itself */
+	for (next = (idx + 1U) & _table->mask; _table->slots[next].node != NULL; next = (next + 1U) & _table->mask) {
+		home = _table->slots[next].hash & _table->mask;
+		if (((next - home) & _table->mask) >= ((next - idx) & _table->mask)) {
+			_table->slots[idx] = _table->slots[next];
+			idx = next;
+		}
+	}
+
+	_table->slots[idx].node = NULL;
+	_table->slots[idx].hash = 0;
+	_table->count--;
+	return EOK;
+}
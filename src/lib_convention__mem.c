@@ -27,14 +27,25 @@
  * includes
  * ******************************************************************/
 
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
 #ifdef CONFIG__FREERTOS_ALLOC
 	#include <FreeRTOS.h>
+	#include <task.h>
 #endif 
 
 #ifdef CONFIG__UNIX_ALLOC
-	#include <stdlib.h>
+	#include "lib_convention__tcache.h"
+	#include "lib_convention__mem_stats_hook.h"
 #endif
 
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__mem.h>
+
 /* *******************************************************************
  * function definition
  * ******************************************************************/
@@ -44,6 +55,10 @@
 void* alloc_memory(unsigned int _count, size_t _size)
 {
 	void *mem;
+
+	if ((_size != 0) && (_count > (SIZE_MAX / _size))) {
+		return NULL;
+	}
 	mem = (void*)pvPortMalloc(_count * _size);
 	if (mem) {
 		memset(mem,0,_count * _size);
@@ -60,20 +75,301 @@ void free_memory(void* _mem)
 	vPortFree(_mem);
 }
 
+int alloc_memory_uninit(void **_mem, unsigned int _count, size_t _size)
+{
+	if (_mem == NULL) {
+		return -EPAR_NULL;
+	}
+	if ((_size != 0) && (_count > (SIZE_MAX / _size))) {
+		return -EPAR_RANGE;
+	}
+	*_mem = pvPortMalloc(_count * _size);
+	return (*_mem == NULL) ? -ESTD_NOMEM : EOK;
+}
+
+int alloc_memory_checked(void **_mem, unsigned int _count, size_t _size)
+{
+	int ret;
+
+	ret = alloc_memory_uninit(_mem, _count, _size);
+	if (ret == EOK) {
+		memset(*_mem, 0, _count * _size);
+	}
+	return ret;
+}
+
+int realloc_memory(void **_mem, size_t _old_size, size_t _size)
+{
+	void *mem;
+
+	if (_mem == NULL) {
+		return -EPAR_NULL;
+	}
+
+	/* heap_x.c of FreeRTOS offers no realloc, move the content */
+	mem = pvPortMalloc(_size);
+	if (mem == NULL) {
+		return -ESTD_NOMEM;
+	}
+	if (*_mem != NULL) {
+		memcpy(mem, *_mem, (_old_size < _size) ? _old_size : _size);
+		vPortFree(*_mem);
+	}
+	*_mem = mem;
+	return EOK;
+}
+
+void free_memory_sized(void* _mem, size_t _size)
+{
+	(void)_size;
+	free_memory(_mem);
+}
+
+int alloc_memory_bulk(void **_mem, unsigned int _count, size_t _size)
+{
+	unsigned int i;
+
+	if (_mem == NULL) {
+		return -EPAR_NULL;
+	}
+
+	/* heap_x.c suspends the scheduler per call, nested suspends are a counter increment */
+	vTaskSuspendAll();
+	for (i = 0; i < _count; i++) {
+		_mem[i] = pvPortMalloc(_size);
+		if (_mem[i] == NULL) {
+			break;
+		}
+	}
+	if (i < _count) {
+		while (i > 0) {
+			vPortFree(_mem[--i]);
+		}
+		(void)xTaskResumeAll();
+		return -ESTD_NOMEM;
+	}
+	(void)xTaskResumeAll();
+
+	for (i = 0; i < _count; i++) {
+		memset(_mem[i], 0, _size);
+	}
+	return EOK;
+}
+
+void free_memory_bulk(void **_mem, unsigned int _count)
+{
+	unsigned int i;
+
+	if (_mem == NULL) {
+		return;
+	}
+
+	vTaskSuspendAll();
+	for (i = 0; i < _count; i++) {
+		if (_mem[i] != NULL) {
+			vPortFree(_mem[i]);
+		}
+	}
+	(void)xTaskResumeAll();
+}
+
+void* alloc_memory_aligned(unsigned int _count, size_t _size, size_t _align)
+{
+	uintptr_t raw, mem;
+	size_t size;
+
+	if (((_align & (_align - 1)) != 0) || ((_size != 0) && (_count > (SIZE_MAX / _size)))) {
+		return NULL;
+	}
+	size = (size_t)_count * _size;
+	if (_align < sizeof(void*)) {
+		_align = sizeof(void*);
+	}
+	if (size > (SIZE_MAX - _align - sizeof(void*))) {
+		return NULL;
+	}
+
+	/* the original pointer is kept in front of the aligned block */
+	raw = (uintptr_t)pvPortMalloc(size + _align + sizeof(void*));
+	if (raw == 0) {
+		return NULL;
+	}
+	mem = ALIGN(raw + sizeof(void*), (uintptr_t)_align);
+	((void**)mem)[-1] = (void*)raw;
+	memset((void*)mem, 0, size);
+	return (void*)mem;
+}
+
+void free_memory_aligned(void* _mem)
+{
+	if (_mem == NULL) {
+		return;
+	}
+	vPortFree(((void**)_mem)[-1]);
+}
+
+void* alloc_memory_large(size_t _size)
+{
+	return alloc_memory(1, _size);
+}
+
+void free_memory_large(void* _mem)
+{
+	free_memory(_mem);
+}
+
 #elif defined(CONFIG__UNIX_ALLOC)
 
 void* alloc_memory(unsigned int _count, size_t _size)
 {
-	void *mem = calloc(_count,_size);
+	void *mem;
+
+	if ((_size != 0) && (_count > (SIZE_MAX / _size))) {
+		return NULL;
+	}
+	mem = tcache__alloc((size_t)_count * _size);
+	MEM_STATS__ON_ALLOC(mem, __builtin_return_address(0));
 	return mem;
 }
 
 void free_memory(void* _mem) 
 {
-	if(_mem == NULL) {
+	MEM_STATS__ON_FREE(_mem);
+	tcache__free(_mem);
+}
+
+int alloc_memory_uninit(void **_mem, unsigned int _count, size_t _size)
+{
+	if (_mem == NULL) {
+		return -EPAR_NULL;
+	}
+	if ((_size != 0) && (_count > (SIZE_MAX / _size))) {
+		return -EPAR_RANGE;
+	}
+	*_mem = tcache__alloc_uninit(_count * _size);
+	if (*_mem == NULL) {
+		return -ESTD_NOMEM;
+	}
+	MEM_STATS__ON_ALLOC(*_mem, __builtin_return_address(0));
+	return EOK;
+}
+
+int alloc_memory_checked(void **_mem, unsigned int _count, size_t _size)
+{
+	if (_mem == NULL) {
+		return -EPAR_NULL;
+	}
+	if ((_size != 0) && (_count > (SIZE_MAX / _size))) {
+		return -EPAR_RANGE;
+	}
+	*_mem = tcache__alloc(_count * _size);
+	if (*_mem == NULL) {
+		return -ESTD_NOMEM;
+	}
+	MEM_STATS__ON_ALLOC(*_mem, __builtin_return_address(0));
+	return EOK;
+}
+
+int realloc_memory(void **_mem, size_t _old_size, size_t _size)
+{
+	void *mem;
+#ifdef CONFIG__MEM_STATS
+	size_t usable;
+#endif
+
+	(void)_old_size;
+	if (_mem == NULL) {
+		return -EPAR_NULL;
+	}
+
+#ifdef CONFIG__MEM_STATS
+	/* the old block is released by a successful realloc, its size is taken before */
+	usable = (*_mem != NULL) ? tcache__usable_size(*_mem) : 0;
+#endif
+	mem = tcache__realloc(*_mem, _size);
+	if (mem == NULL) {
+		return -ESTD_NOMEM;
+	}
+	MEM_STATS__ON_FREE_USABLE(*_mem, usable);
+	MEM_STATS__ON_ALLOC(mem, __builtin_return_address(0));
+	*_mem = mem;
+	return EOK;
+}
+
+void free_memory_sized(void* _mem, size_t _size)
+{
+	MEM_STATS__ON_FREE(_mem);
+	tcache__free_sized(_mem, _size);
+}
+
+int alloc_memory_bulk(void **_mem, unsigned int _count, size_t _size)
+{
+#ifdef CONFIG__MEM_STATS
+	unsigned int i;
+#endif
+
+	if (_mem == NULL) {
+		return -EPAR_NULL;
+	}
+	if (tcache__alloc_bulk(_size, _mem, _count) != 0) {
+		return -ESTD_NOMEM;
+	}
+#ifdef CONFIG__MEM_STATS
+	for (i = 0; i < _count; i++) {
+		MEM_STATS__ON_ALLOC(_mem[i], __builtin_return_address(0));
+	}
+#endif
+	return EOK;
+}
+
+void free_memory_bulk(void **_mem, unsigned int _count)
+{
+#ifdef CONFIG__MEM_STATS
+	unsigned int i;
+#endif
+
+	if (_mem == NULL) {
 		return;
 	}
-	free(_mem);
+#ifdef CONFIG__MEM_STATS
+	for (i = 0; i < _count; i++) {
+		MEM_STATS__ON_FREE(_mem[i]);
+	}
+#endif
+	tcache__free_bulk(_mem, _count);
+}
+
+void* alloc_memory_aligned(unsigned int _count, size_t _size, size_t _align)
+{
+	void *mem;
+
+	if (((_align & (_align - 1)) != 0) || ((_size != 0) && (_count > (SIZE_MAX / _size)))) {
+		return NULL;
+	}
+	mem = tcache__alloc_aligned((size_t)_count * _size, _align);
+	MEM_STATS__ON_ALLOC(mem, __builtin_return_address(0));
+	return mem;
+}
+
+void free_memory_aligned(void* _mem)
+{
+	MEM_STATS__ON_FREE(_mem);
+	tcache__free(_mem);
+}
+
+void* alloc_memory_large(size_t _size)
+{
+	void *mem;
+
+	mem = tcache__alloc_mapped(_size);
+	MEM_STATS__ON_ALLOC(mem, __builtin_return_address(0));
+	return mem;
+}
+
+void free_memory_large(void* _mem)
+{
+	MEM_STATS__ON_FREE(_mem);
+	tcache__free(_mem);
 }
 
 
@@ -0,0 +1,198 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <time.h>
+
+/* system */
+#include <pthread.h>
+#ifdef __GLIBC__
+	#include <malloc.h>
+#endif
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__mem_purge.h>
+
+/* project */
+#include "lib_convention__tcache.h"
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* the background thread checks four times per decay period */
+#define MEM_PURGE__WAKEUPS		4U
+#define MEM_PURGE__MIN_WAIT_MS	10U
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static void* mem_purge__worker(void *_arg);
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+static pthread_mutex_t s_worker_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_worker_cond;
+static pthread_t s_worker;
+static int s_worker_running;
+static int s_worker_stop;
+static unsigned int s_decay_ms = TCACHE__DECAY_MS;
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int mem_purge__configure(const struct mem_purge_config *_config)
+{
+	if (_config == NULL) {
+		return -EPAR_NULL;
+	}
+
+	pthread_mutex_lock(&s_worker_lock);
+	s_decay_ms = _config->decay_ms;
+	if (s_worker_running) {
+		pthread_cond_signal(&s_worker_cond);
+	}
+	pthread_mutex_unlock(&s_worker_lock);
+
+	tcache__purge_configure(_config->decay_ms, _config->ceiling, _config->lazy);
+	return EOK;
+}
+
+int mem_purge__run(void)
+{
+	tcache__purge(0);
+	return EOK;
+}
+
+int mem_purge__trim(void)
+{
+	tcache__purge(TCACHE__PURGE_DIRTY | TCACHE__PURGE_UNMAP);
+#ifdef __GLIBC__
+	/* blocks above the thread cache classes are served by malloc() */
+	malloc_trim(0);
+#endif
+	return EOK;
+}
+
+int mem_purge__start(void)
+{
+	pthread_condattr_t attr;
+	int ret = EOK;
+
+	pthread_mutex_lock(&s_worker_lock);
+	if (s_worker_running) {
+		pthread_mutex_unlock(&s_worker_lock);
+		return -ESTD_EXIST;
+	}
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&s_worker_cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	s_worker_stop = 0;
+	if (pthread_create(&s_worker, NULL, mem_purge__worker, NULL) != 0) {
+		pthread_cond_destroy(&s_worker_cond);
+		ret = -ESTD_AGAIN;
+	}
+	else {
+		s_worker_running = 1;
+	}
+	pthread_mutex_unlock(&s_worker_lock);
+	return ret;
+}
+
+int mem_purge__stop(void)
+{
+	pthread_mutex_lock(&s_worker_lock);
+	if (!s_worker_running) {
+		pthread_mutex_unlock(&s_worker_lock);
+		return -ESTD_NOENT;
+	}
+	s_worker_stop = 1;
+	pthread_cond_signal(&s_worker_cond);
+	pthread_mutex_unlock(&s_worker_lock);
+
+	pthread_join(s_worker, NULL);
+
+	pthread_mutex_lock(&s_worker_lock);
+	pthread_cond_destroy(&s_worker_cond);
+	s_worker_running = 0;
+	pthread_mutex_unlock(&s_worker_lock);
+	return EOK;
+}
+
+int mem_purge__stats(struct mem_purge_stats *_stats)
+{
+	if (_stats == NULL) {
+		return -EPAR_NULL;
+	}
+
+	tcache__purge_stats(_stats);
+	return EOK;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static void* mem_purge__worker(void *_arg)
+{
+	struct timespec ts;
+	unsigned int wait_ms;
+
+	(void)_arg;
+	pthread_mutex_lock(&s_worker_lock);
+	while (!s_worker_stop) {
+		wait_ms = s_decay_ms / MEM_PURGE__WAKEUPS;
+		if (wait_ms < MEM_PURGE__MIN_WAIT_MS) {
+			wait_ms = MEM_PURGE__MIN_WAIT_MS;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		ts.tv_sec += (time_t)(wait_ms / 1000U);
+		ts.tv_nsec += (long)(wait_ms % 1000U) * 1000000L;
+		if (ts.tv_nsec >= 1000000000L) {
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000L;
+		}
+		pthread_cond_timedwait(&s_worker_cond, &s_worker_lock, &ts);
+		if (s_worker_stop) {
+			break;
+		}
+
+		pthread_mutex_unlock(&s_worker_lock);
+		tcache__purge_tick();
+		pthread_mutex_lock(&s_worker_lock);
+	}
+	pthread_mutex_unlock(&s_worker_lock);
+	return NULL;
+}
@@ -0,0 +1,227 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <string.h>
+
+/* system */
+#include <pthread.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__mem_stats.h>
+
+/* project */
+#include "lib_convention__mem_stats_hook.h"
+
+#ifdef CONFIG__MEM_STATS
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+__thread struct mem_stats_thread g_mem_stats_thread;
+size_t g_mem_stats_interval;
+
+/* registry of the live threads and counters of the finished ones */
+static pthread_mutex_t s_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t s_registry_once = PTHREAD_ONCE_INIT;
+static pthread_key_t s_registry_key;
+static struct mem_stats_thread *s_registry;
+static struct mem_stats_snapshot s_retired;
+
+/* samples are rare, a mutex protected ring is good enough */
+static pthread_mutex_t s_sample_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct mem_stats_sample s_samples[MEM_STATS__SAMPLE_SLOTS];
+static unsigned int s_sample_head;
+static unsigned int s_sample_count;
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static void mem_stats__init(void);
+static void mem_stats__thread_exit(void *_arg);
+static void mem_stats__merge(struct mem_stats_snapshot *_snap, struct mem_stats_thread *_thread);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int mem_stats__snapshot(struct mem_stats_snapshot *_snap)
+{
+	struct mem_stats_thread *thread;
+
+	if (_snap == NULL) {
+		return -EPAR_NULL;
+	}
+
+	pthread_mutex_lock(&s_registry_lock);
+	*_snap = s_retired;
+	for (thread = s_registry; thread != NULL; thread = thread->next) {
+		mem_stats__merge(_snap, thread);
+	}
+	pthread_mutex_unlock(&s_registry_lock);
+
+	/* counters of different threads are read at slightly different times */
+	_snap->live_objects = (_snap->alloc_calls > _snap->free_calls) ? (_snap->alloc_calls - _snap->free_calls) : 0;
+	_snap->live_bytes = (_snap->alloc_bytes > _snap->free_bytes) ? (_snap->alloc_bytes - _snap->free_bytes) : 0;
+	return EOK;
+}
+
+int mem_stats__set_sample_interval(size_t _bytes)
+{
+	__atomic_store_n(&g_mem_stats_interval, _bytes, __ATOMIC_RELAXED);
+	return EOK;
+}
+
+int mem_stats__read_samples(struct mem_stats_sample *_samples, unsigned int _max)
+{
+	unsigned int i, n;
+
+	if (_samples == NULL) {
+		return -EPAR_NULL;
+	}
+
+	pthread_mutex_lock(&s_sample_lock);
+	n = (_max < s_sample_count) ? _max : s_sample_count;
+	for (i = 0; i < n; i++) {
+		_samples[i] = s_samples[(s_sample_head + MEM_STATS__SAMPLE_SLOTS - s_sample_count + i) % MEM_STATS__SAMPLE_SLOTS];
+	}
+	s_sample_count -= n;
+	pthread_mutex_unlock(&s_sample_lock);
+
+	return (int)n;
+}
+
+void mem_stats__register(struct mem_stats_thread *_thread)
+{
+	pthread_once(&s_registry_once, mem_stats__init);
+
+	pthread_mutex_lock(&s_registry_lock);
+	_thread->prev = NULL;
+	_thread->next = s_registry;
+	if (s_registry != NULL) {
+		s_registry->prev = _thread;
+	}
+	s_registry = _thread;
+	pthread_mutex_unlock(&s_registry_lock);
+
+	_thread->seed = (uint32_t)(uintptr_t)_thread | 1U;
+	_thread->registered = 1;
+	pthread_setspecific(s_registry_key, _thread);
+}
+
+void mem_stats__sample(struct mem_stats_thread *_thread, size_t _size, void *_caller)
+{
+	size_t interval = __atomic_load_n(&g_mem_stats_interval, __ATOMIC_RELAXED);
+	struct mem_stats_sample *sample;
+	uint32_t seed = _thread->seed;
+
+	/* randomize the distance to the next sample in [interval/2, 3*interval/2) */
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	_thread->seed = seed;
+	_thread->sample_left = (int64_t)(interval / 2) + (int64_t)(seed % (interval | 1U));
+
+	pthread_mutex_lock(&s_sample_lock);
+	sample = &s_samples[s_sample_head];
+	sample->caller = _caller;
+	sample->size = _size;
+	sample->weight = (_size > interval) ? _size : interval;
+	s_sample_head = (s_sample_head + 1) % MEM_STATS__SAMPLE_SLOTS;
+	if (s_sample_count < MEM_STATS__SAMPLE_SLOTS) {
+		s_sample_count++;
+	}
+	pthread_mutex_unlock(&s_sample_lock);
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static void mem_stats__init(void)
+{
+	pthread_key_create(&s_registry_key, mem_stats__thread_exit);
+}
+
+static void mem_stats__thread_exit(void *_arg)
+{
+	struct mem_stats_thread *thread = (struct mem_stats_thread*)_arg;
+
+	pthread_mutex_lock(&s_registry_lock);
+	mem_stats__merge(&s_retired, thread);
+	if (thread->prev != NULL) {
+		thread->prev->next = thread->next;
+	}
+	else {
+		s_registry = thread->next;
+	}
+	if (thread->next != NULL) {
+		thread->next->prev = thread->prev;
+	}
+	pthread_mutex_unlock(&s_registry_lock);
+
+	/* a later free from another TLS destructor registers the thread again */
+	memset(thread, 0, sizeof(*thread));
+}
+
+static void mem_stats__merge(struct mem_stats_snapshot *_snap, struct mem_stats_thread *_thread)
+{
+	uint32_t i;
+
+	_snap->alloc_calls += __atomic_load_n(&_thread->alloc_calls, __ATOMIC_RELAXED);
+	_snap->free_calls += __atomic_load_n(&_thread->free_calls, __ATOMIC_RELAXED);
+	_snap->alloc_bytes += __atomic_load_n(&_thread->alloc_bytes, __ATOMIC_RELAXED);
+	_snap->free_bytes += __atomic_load_n(&_thread->free_bytes, __ATOMIC_RELAXED);
+	for (i = 0; i < MEM_STATS__HIST_BUCKETS; i++) {
+		_snap->histogram[i] += __atomic_load_n(&_thread->histogram[i], __ATOMIC_RELAXED);
+	}
+}
+
+#else /* CONFIG__MEM_STATS */
+
+int mem_stats__snapshot(struct mem_stats_snapshot *_snap)
+{
+	(void)_snap;
+	return -EEXEC_OPNOTSUPP;
+}
+
+int mem_stats__set_sample_interval(size_t _bytes)
+{
+	(void)_bytes;
+	return -EEXEC_OPNOTSUPP;
+}
+
+int mem_stats__read_samples(struct mem_stats_sample *_samples, unsigned int _max)
+{
+	(void)_samples;
+	(void)_max;
+	return -EEXEC_OPNOTSUPP;
+}
+
+#endif /* CONFIG__MEM_STATS */
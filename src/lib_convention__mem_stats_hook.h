@@ -0,0 +1,164 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__MEM_STATS_HOOK_H_
+#define LIB_CONVENTION__MEM_STATS_HOOK_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <stddef.h>
+
+/* own libs */
+#include <lib_convention__mem_stats.h>
+
+/* project */
+#include "lib_convention__tcache.h"
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Accounting hooks of the alloc_memory*() and free_memory*() routines
+ *
+ * 	Expand to nothing unless the library is built with CONFIG__MEM_STATS.
+ * ****************************************************************************/
+#ifdef CONFIG__MEM_STATS
+	#define MEM_STATS__ON_ALLOC(_mem, _caller)	mem_stats__on_alloc((_mem), (_caller))
+	#define MEM_STATS__ON_FREE(_mem)			mem_stats__on_free(_mem)
+	#define MEM_STATS__ON_FREE_USABLE(_mem, _usable)	mem_stats__on_free_usable((_mem), (_usable))
+#else
+	#define MEM_STATS__ON_ALLOC(_mem, _caller)
+	#define MEM_STATS__ON_FREE(_mem)
+	#define MEM_STATS__ON_FREE_USABLE(_mem, _usable)
+#endif
+
+#ifdef CONFIG__MEM_STATS
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Counters of a single thread
+ *
+ * 	Only the owning thread writes, mem_stats__snapshot() reads them with
+ * 	relaxed atomic loads, so the hot path needs neither locks nor RMW
+ * 	instructions.
+ * ****************************************************************************/
+struct mem_stats_thread {
+	uint64_t alloc_calls;
+	uint64_t free_calls;
+	uint64_t alloc_bytes;
+	uint64_t free_bytes;
+	uint64_t histogram[MEM_STATS__HIST_BUCKETS];
+	int64_t sample_left;
+	uint32_t seed;
+	int registered;
+	struct mem_stats_thread *next;
+	struct mem_stats_thread *prev;
+};
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+extern __thread struct mem_stats_thread g_mem_stats_thread;
+extern size_t g_mem_stats_interval;
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+void mem_stats__register(struct mem_stats_thread *_thread);
+void mem_stats__sample(struct mem_stats_thread *_thread, size_t _size, void *_caller);
+
+/* *******************************************************************
+ * static inline function
+ * ******************************************************************/
+
+static inline void mem_stats__add(uint64_t *_counter, uint64_t _value)
+{
+	__atomic_store_n(_counter, *_counter + _value, __ATOMIC_RELAXED);
+}
+
+static inline void mem_stats__on_alloc(void *_mem, void *_caller)
+{
+	struct mem_stats_thread *thread = &g_mem_stats_thread;
+	size_t size;
+	uint32_t bucket;
+
+	if (_mem == NULL) {
+		return;
+	}
+	if (!thread->registered) {
+		mem_stats__register(thread);
+	}
+
+	size = tcache__usable_size(_mem);
+	bucket = 64U - (uint32_t)__builtin_clzll((unsigned long long)size | 1ULL);
+	if (bucket >= MEM_STATS__HIST_BUCKETS) {
+		bucket = MEM_STATS__HIST_BUCKETS - 1;
+	}
+
+	mem_stats__add(&thread->alloc_calls, 1);
+	mem_stats__add(&thread->alloc_bytes, size);
+	mem_stats__add(&thread->histogram[bucket], 1);
+
+	if (__atomic_load_n(&g_mem_stats_interval, __ATOMIC_RELAXED) != 0) {
+		thread->sample_left -= (int64_t)size;
+		if (thread->sample_left < 0) {
+			mem_stats__sample(thread, size, _caller);
+		}
+	}
+}
+
+/* for blocks which are already released, _usable is taken before */
+static inline void mem_stats__on_free_usable(void *_mem, size_t _usable)
+{
+	struct mem_stats_thread *thread = &g_mem_stats_thread;
+
+	if (_mem == NULL) {
+		return;
+	}
+	if (!thread->registered) {
+		mem_stats__register(thread);
+	}
+
+	mem_stats__add(&thread->free_calls, 1);
+	mem_stats__add(&thread->free_bytes, _usable);
+}
+
+static inline void mem_stats__on_free(void *_mem)
+{
+	if (_mem != NULL) {
+		mem_stats__on_free_usable(_mem, tcache__usable_size(_mem));
+	}
+}
+
+#endif /* CONFIG__MEM_STATS */
+
+#endif /* LIB_CONVENTION__MEM_STATS_HOOK_H_ */
@@ -0,0 +1,206 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__mpmc.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* distance of a cell sequence to the expected one, positions wrap around */
+#define MPMC__DIFF(_seq, _pos)		((intptr_t)((_seq) - (_pos)))
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int mpmc_queue__init(struct mpmc_queue *_queue, void *_buffer, size_t _buffer_size, unsigned int _count)
+{
+	uintptr_t capacity, i;
+
+	if ((_queue == NULL) || (_buffer == NULL)) {
+		return -EPAR_NULL;
+	}
+	if ((_count == 0) || (_count > 0x80000000U)) {
+		return -EPAR_RANGE;
+	}
+
+	capacity = MPMC_QUEUE__CAPACITY(_count);
+	if (_buffer_size < (capacity * sizeof(struct mpmc_cell))) {
+		return -EPAR_RANGE;
+	}
+
+	memset(_queue, 0, sizeof(*_queue));
+	_queue->cells = (struct mpmc_cell*)_buffer;
+	_queue->mask = capacity - 1U;
+	for (i = 0; i < capacity; i++) {
+		_queue->cells[i].seq = i;
+		_queue->cells[i].data = NULL;
+	}
+	return EOK;
+}
+
+int mpmc_queue__push(struct mpmc_queue *_queue, void *_item)
+{
+	uintptr_t pos = __atomic_load_n(&_queue->enqueue_pos, __ATOMIC_RELAXED);
+	struct mpmc_cell *cell;
+	intptr_t diff;
+
+	for (;;) {
+		cell = &_queue->cells[pos & _queue->mask];
+		diff = MPMC__DIFF(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE), pos);
+		if (diff == 0) {
+			if (__atomic_compare_exchange_n(&_queue->enqueue_pos, &pos, pos + 1U, 1,
+											__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		}
+		else if (diff < 0) {
+			/* the cell still holds the item of the previous round */
+			return -ELIST_OVERFLOW;
+		}
+		else {
+			pos = __atomic_load_n(&_queue->enqueue_pos, __ATOMIC_RELAXED);
+		}
+	}
+
+	cell->data = _item;
+	__atomic_store_n(&cell->seq, pos + 1U, __ATOMIC_RELEASE);
+	return EOK;
+}
+
+int mpmc_queue__pop(struct mpmc_queue *_queue, void **_item)
+{
+	uintptr_t pos = __atomic_load_n(&_queue->dequeue_pos, __ATOMIC_RELAXED);
+	struct mpmc_cell *cell;
+	intptr_t diff;
+
+	for (;;) {
+		cell = &_queue->cells[pos & _queue->mask];
+		diff = MPMC__DIFF(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE), pos + 1U);
+		if (diff == 0) {
+			if (__atomic_compare_exchange_n(&_queue->dequeue_pos, &pos, pos + 1U, 1,
+											__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+		}
+		else if (diff < 0) {
+			return -ESTD_AGAIN;
+		}
+		else {
+			pos = __atomic_load_n(&_queue->dequeue_pos, __ATOMIC_RELAXED);
+		}
+	}
+
+	*_item = cell->data;
+	__atomic_store_n(&cell->seq, pos + _queue->mask + 1U, __ATOMIC_RELEASE);
+	return EOK;
+}
+
+int mpmc_queue__push_bulk(struct mpmc_queue *_queue, void *const *_items, unsigned int _count)
+{
+	uintptr_t pos = __atomic_load_n(&_queue->enqueue_pos, __ATOMIC_RELAXED);
+	uintptr_t seq = 0, n, i;
+	struct mpmc_cell *cell;
+
+	if (_count == 0) {
+		return 0;
+	}
+
+	for (;;) {
+		/* claim the run of free cells at the enqueue position at once */
+		for (n = 0; n < _count; n++) {
+			seq = __atomic_load_n(&_queue->cells[(pos + n) & _queue->mask].seq, __ATOMIC_ACQUIRE);
+			if (seq != (pos + n)) {
+				break;
+			}
+		}
+		if (n == 0) {
+			if (MPMC__DIFF(seq, pos) < 0) {
+				return -ELIST_OVERFLOW;
+			}
+			pos = __atomic_load_n(&_queue->enqueue_pos, __ATOMIC_RELAXED);
+			continue;
+		}
+		if (__atomic_compare_exchange_n(&_queue->enqueue_pos, &pos, pos + n, 1,
+										__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			break;
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		cell = &_queue->cells[(pos + i) & _queue->mask];
+		cell->data = _items[i];
+		__atomic_store_n(&cell->seq, pos + i + 1U, __ATOMIC_RELEASE);
+	}
+	return (int)n;
+}
+
+int mpmc_queue__pop_bulk(struct mpmc_queue *_queue, void **_items, unsigned int _count)
+{
+	uintptr_t pos = __atomic_load_n(&_queue->dequeue_pos, __ATOMIC_RELAXED);
+	uintptr_t seq = 0, n, i;
+	struct mpmc_cell *cell;
+
+	if (_count == 0) {
+		return 0;
+	}
+
+	for (;;) {
+		for (n = 0; n < _count; n++) {
+			seq = __atomic_load_n(&_queue->cells[(pos + n) & _queue->mask].seq, __ATOMIC_ACQUIRE);
+			if (seq != (pos + n + 1U)) {
+				break;
+			}
+		}
+		if (n == 0) {
+			if (MPMC__DIFF(seq, pos + 1U) < 0) {
+				return -ESTD_AGAIN;
+			}
+			pos = __atomic_load_n(&_queue->dequeue_pos, __ATOMIC_RELAXED);
+			continue;
+		}
+		if (__atomic_compare_exchange_n(&_queue->dequeue_pos, &pos, pos + n, 1,
+										__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			break;
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		cell = &_queue->cells[(pos + i) & _queue->mask];
+		_items[i] = cell->data;
+		__atomic_store_n(&cell->seq, pos + i + _queue->mask + 1U, __ATOMIC_RELEASE);
+	}
+	return (int)n;
+}
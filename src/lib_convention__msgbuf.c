@@ -0,0 +1,290 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__mem.h>
+#include <lib_convention__pool.h>
+#include <lib_convention__msgbuf.h>
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Data block, shared by all views on it
+ * ****************************************************************************/
+struct msgbuf_block {
+	uint32_t refcnt;
+	uint32_t reserved;
+	uint8_t data[];
+};
+
+struct msgbuf_pool {
+	struct mem_pool blocks;
+	struct mem_pool views;
+	size_t block_size;
+	size_t headroom;
+};
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static struct msgbuf* msgbuf__view(struct msgbuf_pool *_pool, struct msgbuf_block *_block,
+								   uint8_t *_data, size_t _len);
+static inline int msgbuf__exclusive(const struct msgbuf *_buf);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int msgbuf_pool__create(struct msgbuf_pool **_pool, unsigned int _blocks, size_t _block_size,
+						unsigned int _views, size_t _headroom)
+{
+	struct msgbuf_pool *pool;
+	size_t head_size, block_bytes, view_bytes;
+	uint8_t *mem;
+	int ret;
+
+	if (_pool == NULL) {
+		return -EPAR_NULL;
+	}
+	if ((_blocks == 0) || (_views < _blocks) || (_block_size == 0) || (_headroom >= _block_size) ||
+		(_block_size > (SIZE_MAX / 2))) {
+		return -EPAR_RANGE;
+	}
+
+	/* pool, blocks and views share a single allocation, none of the sizes may wrap */
+	head_size = ALIGN(sizeof(struct msgbuf_pool), MEM__CACHE_LINE);
+	if (MEM_POOL__STRIDE(sizeof(struct msgbuf_block) + _block_size) > (SIZE_MAX / _blocks)) {
+		return -EPAR_RANGE;
+	}
+	block_bytes = MEM_POOL__BUFFER_SIZE(sizeof(struct msgbuf_block) + _block_size, _blocks);
+	if (MEM_POOL__STRIDE(sizeof(struct msgbuf)) > (SIZE_MAX / _views)) {
+		return -EPAR_RANGE;
+	}
+	view_bytes = MEM_POOL__BUFFER_SIZE(sizeof(struct msgbuf), _views);
+	if ((block_bytes > (SIZE_MAX - head_size)) || (view_bytes > (SIZE_MAX - head_size - block_bytes))) {
+		return -EPAR_RANGE;
+	}
+
+	mem = (uint8_t*)alloc_memory_aligned(1, head_size + block_bytes + view_bytes, MEM__CACHE_LINE);
+	if (mem == NULL) {
+		return -ESTD_NOMEM;
+	}
+
+	pool = (struct msgbuf_pool*)mem;
+	pool->block_size = _block_size;
+	pool->headroom = _headroom;
+	ret = mem_pool__init(&pool->blocks, mem + head_size, block_bytes, sizeof(struct msgbuf_block) + _block_size,
+						 _blocks, MEM_POOL__FLAG_LOCKFREE);
+	if (ret == EOK) {
+		ret = mem_pool__init(&pool->views, mem + head_size + block_bytes, view_bytes, sizeof(struct msgbuf),
+							 _views, MEM_POOL__FLAG_LOCKFREE);
+	}
+	if (ret < EOK) {
+		free_memory_aligned(mem);
+		return ret;
+	}
+
+	*_pool = pool;
+	return EOK;
+}
+
+int msgbuf_pool__destroy(struct msgbuf_pool **_pool)
+{
+	if ((_pool == NULL) || (*_pool == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	free_memory_aligned(*_pool);
+	*_pool = NULL;
+	return EOK;
+}
+
+struct msgbuf* msgbuf__alloc(struct msgbuf_pool *_pool)
+{
+	struct msgbuf_block *block;
+	struct msgbuf *buf;
+
+	block = (struct msgbuf_block*)mem_pool__alloc(&_pool->blocks);
+	if (block == NULL) {
+		return NULL;
+	}
+	block->refcnt = 0;
+
+	buf = msgbuf__view(_pool, block, block->data + _pool->headroom, 0);
+	if (buf == NULL) {
+		(void)mem_pool__free(&_pool->blocks, block);
+	}
+	return buf;
+}
+
+void msgbuf__free(struct msgbuf *_buf)
+{
+	struct msgbuf *next;
+
+	for (; _buf != NULL; _buf = next) {
+		next = _buf->next;
+		if (__atomic_sub_fetch(&_buf->block->refcnt, 1U, __ATOMIC_ACQ_REL) == 0) {
+			(void)mem_pool__free(&_buf->pool->blocks, _buf->block);
+		}
+		(void)mem_pool__free(&_buf->pool->views, _buf);
+	}
+}
+
+struct msgbuf* msgbuf__slice(struct msgbuf *_buf, size_t _offset, size_t _len)
+{
+	if ((_buf == NULL) || (_offset > _buf->len) || (_len > (_buf->len - _offset))) {
+		return NULL;
+	}
+	return msgbuf__view(_buf->pool, _buf->block, _buf->data + _offset, _len);
+}
+
+uint8_t* msgbuf__put(struct msgbuf *_buf, size_t _len)
+{
+	uint8_t *tail = _buf->data + _buf->len;
+
+	if (!msgbuf__exclusive(_buf) || (_len > msgbuf__tailroom(_buf))) {
+		return NULL;
+	}
+	_buf->len += _len;
+	return tail;
+}
+
+uint8_t* msgbuf__push(struct msgbuf *_buf, size_t _len)
+{
+	if (!msgbuf__exclusive(_buf) || (_len > msgbuf__headroom(_buf))) {
+		return NULL;
+	}
+	_buf->data -= _len;
+	_buf->len += _len;
+	return _buf->data;
+}
+
+uint8_t* msgbuf__pull(struct msgbuf *_buf, size_t _len)
+{
+	uint8_t *head = _buf->data;
+
+	if (_len > _buf->len) {
+		return NULL;
+	}
+	_buf->data += _len;
+	_buf->len -= _len;
+	return head;
+}
+
+size_t msgbuf__headroom(const struct msgbuf *_buf)
+{
+	return (size_t)(_buf->data - _buf->block->data);
+}
+
+size_t msgbuf__tailroom(const struct msgbuf *_buf)
+{
+	return _buf->pool->block_size - msgbuf__headroom(_buf) - _buf->len;
+}
+
+void msgbuf__chain(struct msgbuf *_head, struct msgbuf *_tail)
+{
+	while (_head->next != NULL) {
+		_head = _head->next;
+	}
+	_head->next = _tail;
+}
+
+size_t msgbuf__length(const struct msgbuf *_buf)
+{
+	size_t len = 0;
+
+	for (; _buf != NULL; _buf = _buf->next) {
+		len += _buf->len;
+	}
+	return len;
+}
+
+int msgbuf__to_iovec(const struct msgbuf *_buf, msgbuf_iovec_t *_iov, unsigned int _max)
+{
+	unsigned int n = 0;
+
+	if (_iov == NULL) {
+		return -EPAR_NULL;
+	}
+
+	for (; _buf != NULL; _buf = _buf->next) {
+		/* empty fragments would only cost the kernel a loop iteration */
+		if (_buf->len == 0) {
+			continue;
+		}
+		if (n == _max) {
+			return -ELIST_OVERFLOW;
+		}
+		_iov[n].iov_base = _buf->data;
+		_iov[n].iov_len = _buf->len;
+		n++;
+	}
+	return (int)n;
+}
+
+void msgbuf__tail_iovec(const struct msgbuf *_buf, msgbuf_iovec_t *_iov)
+{
+	_iov->iov_base = _buf->data + _buf->len;
+	_iov->iov_len = msgbuf__tailroom(_buf);
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static struct msgbuf* msgbuf__view(struct msgbuf_pool *_pool, struct msgbuf_block *_block,
+								   uint8_t *_data, size_t _len)
+{
+	struct msgbuf *buf;
+
+	buf = (struct msgbuf*)mem_pool__alloc(&_pool->views);
+	if (buf == NULL) {
+		return NULL;
+	}
+
+	__atomic_add_fetch(&_block->refcnt, 1U, __ATOMIC_RELAXED);
+	buf->next = NULL;
+	buf->data = _data;
+	buf->len = _len;
+	buf->block = _block;
+	buf->pool = _pool;
+	return buf;
+}
+
+static inline int msgbuf__exclusive(const struct msgbuf *_buf)
+{
+	return __atomic_load_n(&_buf->block->refcnt, __ATOMIC_ACQUIRE) == 1U;
+}
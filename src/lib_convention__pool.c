@@ -0,0 +1,157 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__pool.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* Split of the free list head into block index (low) and ABA tag (high) */
+#if UINTPTR_MAX > 0xFFFFFFFFU
+	#define MEM_POOL__IDX_BITS	32U
+#else
+	#define MEM_POOL__IDX_BITS	16U
+#endif
+#define MEM_POOL__IDX_MASK		((mem_pool_head_t)BITMASK(MEM_POOL__IDX_BITS))
+#define MEM_POOL__IDX_NONE		MEM_POOL__IDX_MASK
+
+/* Link to the next free block, stored in the first bytes of a free block */
+#define MEM_POOL__LINK(_pool, _idx)	((uint32_t*)((_pool)->base + ((size_t)(_idx) * (_pool)->stride)))
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int mem_pool__init(struct mem_pool *_pool, void *_buffer, size_t _buffer_size,
+				   size_t _block_size, unsigned int _count, unsigned int _flags)
+{
+	size_t stride;
+	uint32_t i;
+
+	if ((_pool == NULL) || (_buffer == NULL)) {
+		return -EPAR_NULL;
+	}
+	if ((_count == 0) || ((mem_pool_head_t)_count >= MEM_POOL__IDX_NONE) ||
+		(((uintptr_t)_buffer & (MEM_POOL__BLOCK_ALIGN - 1)) != 0)) {
+		return -EPAR_RANGE;
+	}
+
+	stride = MEM_POOL__STRIDE(_block_size);
+	if ((stride < _block_size) || (_buffer_size / stride < _count)) {
+		return -EPAR_RANGE;
+	}
+
+	_pool->base = (uint8_t*)_buffer;
+	_pool->stride = stride;
+	_pool->count = _count;
+	_pool->flags = _flags;
+
+	for (i = 0; i < (_count - 1); i++) {
+		*MEM_POOL__LINK(_pool, i) = i + 1;
+	}
+	*MEM_POOL__LINK(_pool, _count - 1) = (uint32_t)MEM_POOL__IDX_NONE;
+	_pool->head = 0;
+
+	if (_flags & MEM_POOL__FLAG_LOCKFREE) {
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+	return EOK;
+}
+
+void* mem_pool__alloc(struct mem_pool *_pool)
+{
+	mem_pool_head_t old, next;
+	uint32_t idx;
+
+	if (_pool == NULL) {
+		return NULL;
+	}
+
+	if (!(_pool->flags & MEM_POOL__FLAG_LOCKFREE)) {
+		idx = (uint32_t)(_pool->head & MEM_POOL__IDX_MASK);
+		if (idx == (uint32_t)MEM_POOL__IDX_NONE) {
+			return NULL;
+		}
+		_pool->head = *MEM_POOL__LINK(_pool, idx);
+		return MEM_POOL__LINK(_pool, idx);
+	}
+
+	old = __atomic_load_n(&_pool->head, __ATOMIC_ACQUIRE);
+	do {
+		idx = (uint32_t)(old & MEM_POOL__IDX_MASK);
+		if (idx == (uint32_t)MEM_POOL__IDX_NONE) {
+			return NULL;
+		}
+		/* the link may be stale if another context won the race, the tag catches it */
+		next = __atomic_load_n(MEM_POOL__LINK(_pool, idx), __ATOMIC_RELAXED);
+		next |= (old & ~MEM_POOL__IDX_MASK) + MEM_POOL__IDX_MASK + 1;
+	} while (!__atomic_compare_exchange_n(&_pool->head, &old, next, 1,
+										  __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+	return MEM_POOL__LINK(_pool, idx);
+}
+
+int mem_pool__free(struct mem_pool *_pool, void *_mem)
+{
+	mem_pool_head_t old, next;
+	size_t offset;
+	uint32_t idx;
+
+	if ((_pool == NULL) || (_mem == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	offset = (size_t)((uint8_t*)_mem - _pool->base);
+	if (((uint8_t*)_mem < _pool->base) || (offset % _pool->stride != 0) ||
+		(offset / _pool->stride >= _pool->count)) {
+		return -EPAR_RANGE;
+	}
+	idx = (uint32_t)(offset / _pool->stride);
+
+	if (!(_pool->flags & MEM_POOL__FLAG_LOCKFREE)) {
+		*MEM_POOL__LINK(_pool, idx) = (uint32_t)(_pool->head & MEM_POOL__IDX_MASK);
+		_pool->head = idx;
+		return EOK;
+	}
+
+	old = __atomic_load_n(&_pool->head, __ATOMIC_RELAXED);
+	do {
+		__atomic_store_n(MEM_POOL__LINK(_pool, idx), (uint32_t)(old & MEM_POOL__IDX_MASK), __ATOMIC_RELAXED);
+		next = ((old & ~MEM_POOL__IDX_MASK) + MEM_POOL__IDX_MASK + 1) | idx;
+	} while (!__atomic_compare_exchange_n(&_pool->head, &old, next, 1,
+										  __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	return EOK;
+}
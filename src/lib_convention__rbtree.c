@@ -0,0 +1,384 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__rbtree.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define RBTREE__RED			0U
+#define RBTREE__BLACK		1U
+
+#define RBTREE__PARENT(_node)		((struct rbtree_node*)((_node)->parent_color & ~(uintptr_t)1U))
+#define RBTREE__COLOR(_node)		((_node)->parent_color & 1U)
+#define RBTREE__IS_RED(_node)		(((_node) != NULL) && (RBTREE__COLOR(_node) == RBTREE__RED))
+#define RBTREE__IS_BLACK(_node)		(((_node) == NULL) || (RBTREE__COLOR(_node) == RBTREE__BLACK))
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static inline void rbtree__set_parent(struct rbtree_node *_node, struct rbtree_node *_parent);
+static inline void rbtree__set_color(struct rbtree_node *_node, uintptr_t _color);
+static void rbtree__replace_child(struct rbtree *_tree, struct rbtree_node *_parent,
+								  struct rbtree_node *_old, struct rbtree_node *_new);
+static void rbtree__rotate_left(struct rbtree *_tree, struct rbtree_node *_node);
+static void rbtree__rotate_right(struct rbtree *_tree, struct rbtree_node *_node);
+static void rbtree__insert_fixup(struct rbtree *_tree, struct rbtree_node *_node);
+static void rbtree__remove_fixup(struct rbtree *_tree, struct rbtree_node *_node, struct rbtree_node *_parent);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int rbtree__insert(struct rbtree *_tree, struct rbtree_node *_node, rbtree_cmp_t _cmp)
+{
+	struct rbtree_node **link = &_tree->root, *parent = NULL;
+	int cmp;
+
+	while (*link != NULL) {
+		parent = *link;
+		cmp = _cmp(_node, parent);
+		if (cmp == 0) {
+			return -ESTD_EXIST;
+		}
+		link = (cmp < 0) ? &parent->left : &parent->right;
+	}
+
+	_node->parent_color = (uintptr_t)parent | RBTREE__RED;
+	_node->left = NULL;
+	_node->right = NULL;
+	*link = _node;
+	rbtree__insert_fixup(_tree, _node);
+	return EOK;
+}
+
+void rbtree__remove(struct rbtree *_tree, struct rbtree_node *_node)
+{
+	struct rbtree_node *child, *parent, *succ;
+	uintptr_t color = RBTREE__COLOR(_node);
+
+	if (_node->left == NULL) {
+		child = _node->right;
+		parent = RBTREE__PARENT(_node);
+		rbtree__replace_child(_tree, parent, _node, child);
+	}
+	else if (_node->right == NULL) {
+		child = _node->left;
+		parent = RBTREE__PARENT(_node);
+		rbtree__replace_child(_tree, parent, _node, child);
+	}
+	else {
+		/* the in-order successor takes the place and the color of the node */
+		for (succ = _node->right; succ->left != NULL; succ = succ->left) {
+		}
+		color = RBTREE__COLOR(succ);
+		child = succ->right;
+
+		if (RBTREE__PARENT(succ) == _node) {
+			parent = succ;
+		}
+		else {
+			parent = RBTREE__PARENT(succ);
+			rbtree__replace_child(_tree, parent, succ, child);
+			succ->right = _node->right;
+			rbtree__set_parent(succ->right, succ);
+		}
+		rbtree__replace_child(_tree, RBTREE__PARENT(_node), _node, succ);
+		succ->left = _node->left;
+		rbtree__set_parent(succ->left, succ);
+		rbtree__set_color(succ, RBTREE__COLOR(_node));
+	}
+
+	if (color == RBTREE__BLACK) {
+		rbtree__remove_fixup(_tree, child, parent);
+	}
+}
+
+struct rbtree_node* rbtree__find(const struct rbtree *_tree, const void *_key, rbtree_cmp_key_t _cmp)
+{
+	struct rbtree_node *node = _tree->root;
+	int cmp;
+
+	while (node != NULL) {
+		cmp = _cmp(_key, node);
+		if (cmp == 0) {
+			return node;
+		}
+		node = (cmp < 0) ? node->left : node->right;
+	}
+	return NULL;
+}
+
+struct rbtree_node* rbtree__lower_bound(const struct rbtree *_tree, const void *_key, rbtree_cmp_key_t _cmp)
+{
+	struct rbtree_node *node = _tree->root, *bound = NULL;
+
+	while (node != NULL) {
+		if (_cmp(_key, node) <= 0) {
+			bound = node;
+			node = node->left;
+		}
+		else {
+			node = node->right;
+		}
+	}
+	return bound;
+}
+
+struct rbtree_node* rbtree__first(const struct rbtree *_tree)
+{
+	struct rbtree_node *node = _tree->root;
+
+	if (node != NULL) {
+		while (node->left != NULL) {
+			node = node->left;
+		}
+	}
+	return node;
+}
+
+struct rbtree_node* rbtree__last(const struct rbtree *_tree)
+{
+	struct rbtree_node *node = _tree->root;
+
+	if (node != NULL) {
+		while (node->right != NULL) {
+			node = node->right;
+		}
+	}
+	return node;
+}
+
+struct rbtree_node* rbtree__next(const struct rbtree_node *_node)
+{
+	struct rbtree_node *node, *parent;
+
+	if (_node->right != NULL) {
+		for (node = _node->right; node->left != NULL; node = node->left) {
+		}
+		return node;
+	}
+
+	node = (struct rbtree_node*)_node;
+	while (((parent = RBTREE__PARENT(node)) != NULL) && (node == parent->right)) {
+		node = parent;
+	}
+	return parent;
+}
+
+struct rbtree_node* rbtree__prev(const struct rbtree_node *_node)
+{
+	struct rbtree_node *node, *parent;
+
+	if (_node->left != NULL) {
+		for (node = _node->left; node->right != NULL; node = node->right) {
+		}
+		return node;
+	}
+
+	node = (struct rbtree_node*)_node;
+	while (((parent = RBTREE__PARENT(node)) != NULL) && (node == parent->left)) {
+		node = parent;
+	}
+	return parent;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static inline void rbtree__set_parent(struct rbtree_node *_node, struct rbtree_node *_parent)
+{
+	_node->parent_color = (uintptr_t)_parent | RBTREE__COLOR(_node);
+}
+
+static inline void rbtree__set_color(struct rbtree_node *_node, uintptr_t _color)
+{
+	_node->parent_color = (uintptr_t)RBTREE__PARENT(_node) | _color;
+}
+
+static void rbtree__replace_child(struct rbtree *_tree, struct rbtree_node *_parent,
+								  struct rbtree_node *_old, struct rbtree_node *_new)
+{
+	if (_parent == NULL) {
+		_tree->root = _new;
+	}
+	else if (_parent->left == _old) {
+		_parent->left = _new;
+	}
+	else {
+		_parent->right = _new;
+	}
+	if (_new != NULL) {
+		rbtree__set_parent(_new, _parent);
+	}
+}
+
+static void rbtree__rotate_left(struct rbtree *_tree, struct rbtree_node *_node)
+{
+	struct rbtree_node *pivot = _node->right;
+
+	_node->right = pivot->left;
+	if (pivot->left != NULL) {
+		rbtree__set_parent(pivot->left, _node);
+	}
+	rbtree__replace_child(_tree, RBTREE__PARENT(_node), _node, pivot);
+	pivot->left = _node;
+	rbtree__set_parent(_node, pivot);
+}
+
+static void rbtree__rotate_right(struct rbtree *_tree, struct rbtree_node *_node)
+{
+	struct rbtree_node *pivot = _node->left;
+
+	_node->left = pivot->right;
+	if (pivot->right != NULL) {
+		rbtree__set_parent(pivot->right, _node);
+	}
+	rbtree__replace_child(_tree, RBTREE__PARENT(_node), _node, pivot);
+	pivot->right = _node;
+	rbtree__set_parent(_node, pivot);
+}
+
+static void rbtree__insert_fixup(struct rbtree *_tree, struct rbtree_node *_node)
+{
+	struct rbtree_node *parent, *grand, *uncle;
+
+	while (((parent = RBTREE__PARENT(_node)) != NULL) && RBTREE__IS_RED(parent)) {
+		/* a red parent is never the root */
+		grand = RBTREE__PARENT(parent);
+
+		if (parent == grand->left) {
+			uncle = grand->right;
+			if (RBTREE__IS_RED(uncle)) {
+				rbtree__set_color(parent, RBTREE__BLACK);
+				rbtree__set_color(uncle, RBTREE__BLACK);
+				rbtree__set_color(grand, RBTREE__RED);
+				_node = grand;
+				continue;
+			}
+			if (_node == parent->right) {
+				rbtree__rotate_left(_tree, parent);
+				_node = parent;
+				parent = RBTREE__PARENT(_node);
+			}
+			rbtree__set_color(parent, RBTREE__BLACK);
+			rbtree__set_color(grand, RBTREE__RED);
+			rbtree__rotate_right(_tree, grand);
+		}
+		else {
+			uncle = grand->left;
+			if (RBTREE__IS_RED(uncle)) {
+				rbtree__set_color(parent, RBTREE__BLACK);
+				rbtree__set_color(uncle, RBTREE__BLACK);
+				rbtree__set_color(grand, RBTREE__RED);
+				_node = grand;
+				continue;
+			}
+			if (_node == parent->left) {
+				rbtree__rotate_right(_tree, parent);
+				_node = parent;
+				parent = RBTREE__PARENT(_node);
+			}
+			rbtree__set_color(parent, RBTREE__BLACK);
+			rbtree__set_color(grand, RBTREE__RED);
+			rbtree__rotate_left(_tree, grand);
+		}
+	}
+	rbtree__set_color(_tree->root, RBTREE__BLACK);
+}
+
+static void rbtree__remove_fixup(struct rbtree *_tree, struct rbtree_node *_node, struct rbtree_node *_parent)
+{
+	struct rbtree_node *sibling;
+
+	/* _node carries an extra black, _parent is needed as _node may be NULL */
+	while ((_node != _tree->root) && RBTREE__IS_BLACK(_node)) {
+		if (_node == _parent->left) {
+			sibling = _parent->right;
+			if (RBTREE__IS_RED(sibling)) {
+				rbtree__set_color(sibling, RBTREE__BLACK);
+				rbtree__set_color(_parent, RBTREE__RED);
+				rbtree__rotate_left(_tree, _parent);
+				sibling = _parent->right;
+			}
+			if (RBTREE__IS_BLACK(sibling->left) && RBTREE__IS_BLACK(sibling->right)) {
+				rbtree__set_color(sibling, RBTREE__RED);
+				_node = _parent;
+				_parent = RBTREE__PARENT(_node);
+				continue;
+			}
+			if (RBTREE__IS_BLACK(sibling->right)) {
+				rbtree__set_color(sibling->left, RBTREE__BLACK);
+				rbtree__set_color(sibling, RBTREE__RED);
+				rbtree__rotate_right(_tree, sibling);
+				sibling = _parent->right;
+			}
+			rbtree__set_color(sibling, RBTREE__COLOR(_parent));
+			rbtree__set_color(_parent, RBTREE__BLACK);
+			rbtree__set_color(sibling->right, RBTREE__BLACK);
+			rbtree__rotate_left(_tree, _parent);
+		}
+		else {
+			sibling = _parent->left;
+			if (RBTREE__IS_RED(sibling)) {
+				rbtree__set_color(sibling, RBTREE__BLACK);
+				rbtree__set_color(_parent, RBTREE__RED);
+				rbtree__rotate_right(_tree, _parent);
+				sibling = _parent->left;
+			}
+			if (RBTREE__IS_BLACK(sibling->left) && RBTREE__IS_BLACK(sibling->right)) {
+				rbtree__set_color(sibling, RBTREE__RED);
+				_node = _parent;
+				_parent = RBTREE__PARENT(_node);
+				continue;
+			}
+			if (RBTREE__IS_BLACK(sibling->left)) {
+				rbtree__set_color(sibling->right, RBTREE__BLACK);
+				rbtree__set_color(sibling, RBTREE__RED);
+				rbtree__rotate_left(_tree, sibling);
+				sibling = _parent->left;
+			}
+			rbtree__set_color(sibling, RBTREE__COLOR(_parent));
+			rbtree__set_color(_parent, RBTREE__BLACK);
+			rbtree__set_color(sibling->left, RBTREE__BLACK);
+			rbtree__rotate_right(_tree, _parent);
+		}
+		_node = _tree->root;
+		break;
+	}
+
+	if (_node != NULL) {
+		rbtree__set_color(_node, RBTREE__BLACK);
+	}
+}
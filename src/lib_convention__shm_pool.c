@@ -0,0 +1,701 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+/* system */
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__mem.h>
+#include <lib_convention__shm_pool.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define SHM_POOL__MAGIC		0x53484D50U		/* "SHMP" */
+#define SHM_POOL__VERSION	2U
+
+/* operations of all processes which may run at the same time, see struct shm_pool_op */
+#define SHM_POOL__OP_SLOTS	64U
+
+/* free list entries are block index + 1, 0 terminates the list */
+#define SHM_POOL__LINK_END	0U
+#define SHM_POOL__HEAD(_tag, _link)		(((uint64_t)(_tag) << 32) | (uint64_t)(_link))
+#define SHM_POOL__HEAD_TAG(_head)		((uint32_t)((_head) >> 32))
+#define SHM_POOL__HEAD_LINK(_head)		((uint32_t)(_head))
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Header at offset 0 of the region
+ *
+ * 	Only fixed width members, the layout has to be identical in every
+ * 	process. magic is written last by the creator and tells the other
+ * 	processes that the set up is complete.
+ * ****************************************************************************/
+struct shm_pool_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint64_t size;
+	uint64_t stride;
+	uint64_t desc_offset;
+	uint64_t data_offset;
+	uint32_t blocks;
+	uint32_t available;
+	uint64_t free_head;
+	uint32_t recover_pid;
+	uint32_t reserved;
+};
+
+/* ************************************************************************//**
+ * \brief	Announcement of a running shm_pool__alloc() or shm_pool__free()
+ *
+ * 	A block is in the free list or has an owner, except for the few
+ * 	instructions in which an operation moves it between both. A process
+ * 	killed in there leaves the block in neither place. The slot tells
+ * 	shm_pool__recover() that an operation of a process is in flight, once
+ * 	no live process has one the free list is rebuilt from the owners.
+ * 	Slots are padded to a cache line, they are written on every operation.
+ * ****************************************************************************/
+struct shm_pool_op {
+	uint32_t pid;
+	uint8_t pad[SHM_POOL__BLOCK_ALIGN - sizeof(uint32_t)];
+};
+
+/* ************************************************************************//**
+ * \brief	Per block bookkeeping, kept apart from the blocks so a process
+ * 			scribbling over its buffer does not corrupt the free list
+ *
+ * \param	next	: next free block while the block is in the free list
+ * \param	owner	: pid of the owning process, 0 while the block is free
+ * ****************************************************************************/
+struct shm_pool_desc {
+	uint32_t next;
+	uint32_t owner;
+};
+
+struct shm_pool {
+	uint8_t *base;
+	size_t size;
+	int fd;
+	struct shm_pool_hdr *hdr;
+	struct shm_pool_op *ops;
+	struct shm_pool_desc *desc;
+};
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+
+/* pid of the process, getpid() is a system call and the child of fork() updates it */
+static pthread_once_t s_pid_once = PTHREAD_ONCE_INIT;
+static uint32_t s_pid;
+
+/* slot taken by the last operation of the thread, keeps threads on different slots */
+static __thread uint32_t s_op_hint;
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static int shm_pool__map(struct shm_pool **_pool, int _fd);
+static int shm_pool__index(const struct shm_pool *_pool, shm_off_t _off, uint32_t *_index);
+static void shm_pool__push(struct shm_pool *_pool, uint32_t _index);
+static uint32_t shm_pool__enter(struct shm_pool *_pool);
+static inline void shm_pool__leave(struct shm_pool *_pool, uint32_t _slot);
+static int shm_pool__rebuild(struct shm_pool *_pool);
+static int shm_pool__dead(uint32_t _pid);
+static void shm_pool__pid_init(void);
+static void shm_pool__pid_update(void);
+static inline uint32_t shm_pool__self(void);
+static int shm_pool__memfd(void);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int shm_pool__create(struct shm_pool **_pool, const char *_name, size_t _block_size, unsigned int _blocks)
+{
+	struct shm_pool_hdr *hdr;
+	struct shm_pool_desc *desc;
+	uint64_t stride, desc_offset, data_offset, size;
+	uint8_t *base;
+	uint32_t i;
+	int fd, ret;
+
+	if (_pool == NULL) {
+		return -EPAR_NULL;
+	}
+	if ((_block_size == 0) || (_blocks == 0) || (_blocks == UINT32_MAX) ||
+		((uint64_t)_block_size > (UINT64_MAX / 2 / _blocks))) {
+		return -EPAR_RANGE;
+	}
+
+	stride = ALIGN((uint64_t)_block_size, (uint64_t)SHM_POOL__BLOCK_ALIGN);
+	desc_offset = ALIGN((uint64_t)sizeof(struct shm_pool_hdr), (uint64_t)SHM_POOL__BLOCK_ALIGN) +
+				  (SHM_POOL__OP_SLOTS * sizeof(struct shm_pool_op));
+	data_offset = ALIGN(desc_offset + ((uint64_t)_blocks * sizeof(struct shm_pool_desc)), (uint64_t)SHM_POOL__BLOCK_ALIGN);
+	size = data_offset + (stride * _blocks);
+	if (size > (uint64_t)SIZE_MAX) {
+		return -EPAR_RANGE;
+	}
+
+	if (_name != NULL) {
+		fd = shm_open(_name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+	}
+	else {
+		fd = shm_pool__memfd();
+	}
+	if (fd < 0) {
+		return convert_std_errno(errno);
+	}
+	if (ftruncate(fd, (off_t)size) != 0) {
+		ret = convert_std_errno(errno);
+		goto ERR_CLOSE;
+	}
+
+	base = (uint8_t*)mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if ((void*)base == MAP_FAILED) {
+		ret = convert_std_errno(errno);
+		goto ERR_CLOSE;
+	}
+
+	hdr = (struct shm_pool_hdr*)base;
+	hdr->version = SHM_POOL__VERSION;
+	hdr->size = size;
+	hdr->stride = stride;
+	hdr->desc_offset = desc_offset;
+	hdr->data_offset = data_offset;
+	hdr->blocks = _blocks;
+	hdr->available = _blocks;
+
+	/* the region starts zeroed, so every owner is already 0 */
+	desc = (struct shm_pool_desc*)(base + desc_offset);
+	for (i = 0; i < _blocks; i++) {
+		desc[i].next = (i + 1 < _blocks) ? (i + 2) : SHM_POOL__LINK_END;
+	}
+	hdr->free_head = SHM_POOL__HEAD(0, 1);
+	__atomic_store_n(&hdr->magic, SHM_POOL__MAGIC, __ATOMIC_RELEASE);
+	munmap(base, (size_t)size);
+
+	ret = shm_pool__map(_pool, fd);
+	if (ret < EOK) {
+		goto ERR_CLOSE;
+	}
+	return EOK;
+
+ERR_CLOSE:
+	close(fd);
+	if (_name != NULL) {
+		shm_unlink(_name);
+	}
+	return ret;
+}
+
+int shm_pool__open(struct shm_pool **_pool, const char *_name)
+{
+	int fd, ret;
+
+	if ((_pool == NULL) || (_name == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	fd = shm_open(_name, O_RDWR | O_CLOEXEC, 0);
+	if (fd < 0) {
+		return convert_std_errno(errno);
+	}
+	ret = shm_pool__map(_pool, fd);
+	if (ret < EOK) {
+		close(fd);
+	}
+	return ret;
+}
+
+int shm_pool__open_fd(struct shm_pool **_pool, int _fd)
+{
+	int fd, ret;
+
+	if (_pool == NULL) {
+		return -EPAR_NULL;
+	}
+
+	fd = fcntl(_fd, F_DUPFD_CLOEXEC, 0);
+	if (fd < 0) {
+		return convert_std_errno(errno);
+	}
+	ret = shm_pool__map(_pool, fd);
+	if (ret < EOK) {
+		close(fd);
+	}
+	return ret;
+}
+
+int shm_pool__close(struct shm_pool **_pool)
+{
+	if ((_pool == NULL) || (*_pool == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	munmap((*_pool)->base, (*_pool)->size);
+	close((*_pool)->fd);
+	free_memory(*_pool);
+	*_pool = NULL;
+	return EOK;
+}
+
+int shm_pool__unlink(const char *_name)
+{
+	if (_name == NULL) {
+		return -EPAR_NULL;
+	}
+	if (shm_unlink(_name) != 0) {
+		return convert_std_errno(errno);
+	}
+	return EOK;
+}
+
+int shm_pool__fd(const struct shm_pool *_pool)
+{
+	if (_pool == NULL) {
+		return -EPAR_NULL;
+	}
+	return _pool->fd;
+}
+
+int shm_pool__alloc(struct shm_pool *_pool, shm_off_t *_off)
+{
+	struct shm_pool_hdr *hdr;
+	uint64_t head, next;
+	uint32_t link, slot;
+
+	if ((_pool == NULL) || (_off == NULL)) {
+		return -EPAR_NULL;
+	}
+	hdr = _pool->hdr;
+	slot = shm_pool__enter(_pool);
+
+	/*
+	 * The link of the head block may be stale if another process takes it
+	 * concurrently. The descriptor stays mapped and the tag of the head
+	 * makes the compare-exchange fail in that case.
+	 */
+	head = __atomic_load_n(&hdr->free_head, __ATOMIC_ACQUIRE);
+	do {
+		link = SHM_POOL__HEAD_LINK(head);
+		if (link == SHM_POOL__LINK_END) {
+			shm_pool__leave(_pool, slot);
+			return -ESTD_NOMEM;
+		}
+		next = SHM_POOL__HEAD(SHM_POOL__HEAD_TAG(head) + 1U,
+							  __atomic_load_n(&_pool->desc[link - 1].next, __ATOMIC_RELAXED));
+	} while (!__atomic_compare_exchange_n(&hdr->free_head, &head, next, 1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+	__atomic_store_n(&_pool->desc[link - 1].owner, shm_pool__self(), __ATOMIC_RELEASE);
+	__atomic_sub_fetch(&hdr->available, 1, __ATOMIC_RELAXED);
+	shm_pool__leave(_pool, slot);
+
+	*_off = hdr->data_offset + ((uint64_t)(link - 1) * hdr->stride);
+	return EOK;
+}
+
+int shm_pool__free(struct shm_pool *_pool, shm_off_t _off)
+{
+	uint32_t index, slot;
+	int ret;
+
+	if (_pool == NULL) {
+		return -EPAR_NULL;
+	}
+	ret = shm_pool__index(_pool, _off, &index);
+	if (ret < EOK) {
+		return ret;
+	}
+
+	/* clearing the owner first lets exactly one of free and recover return the block */
+	slot = shm_pool__enter(_pool);
+	if (__atomic_exchange_n(&_pool->desc[index].owner, 0, __ATOMIC_ACQ_REL) == 0) {
+		shm_pool__leave(_pool, slot);
+		return -EPAR_BADVALUE;
+	}
+	shm_pool__push(_pool, index);
+	shm_pool__leave(_pool, slot);
+	return EOK;
+}
+
+int shm_pool__adopt(struct shm_pool *_pool, shm_off_t _off)
+{
+	uint32_t index, owner;
+	int ret;
+
+	if (_pool == NULL) {
+		return -EPAR_NULL;
+	}
+	ret = shm_pool__index(_pool, _off, &index);
+	if (ret < EOK) {
+		return ret;
+	}
+
+	owner = __atomic_load_n(&_pool->desc[index].owner, __ATOMIC_ACQUIRE);
+	do {
+		if (owner == 0) {
+			return -EPAR_BADVALUE;
+		}
+	} while (!__atomic_compare_exchange_n(&_pool->desc[index].owner, &owner, shm_pool__self(),
+										  1, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+	return EOK;
+}
+
+int shm_pool__recover(struct shm_pool *_pool)
+{
+	uint32_t self, pid;
+	int count;
+
+	if (_pool == NULL) {
+		return -EPAR_NULL;
+	}
+
+	/* one process recovers at a time, the role is taken over from a killed one */
+	self = shm_pool__self();
+	pid = __atomic_load_n(&_pool->hdr->recover_pid, __ATOMIC_ACQUIRE);
+	for (;;) {
+		if ((pid == 0) || shm_pool__dead(pid)) {
+			if (__atomic_compare_exchange_n(&_pool->hdr->recover_pid, &pid, self, 0, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE)) {
+				break;
+			}
+			continue;
+		}
+		sched_yield();
+		pid = __atomic_load_n(&_pool->hdr->recover_pid, __ATOMIC_ACQUIRE);
+	}
+
+	count = shm_pool__rebuild(_pool);
+	__atomic_store_n(&_pool->hdr->recover_pid, 0, __ATOMIC_SEQ_CST);
+	return count;
+}
+
+void* shm_pool__ptr(const struct shm_pool *_pool, shm_off_t _off)
+{
+	if ((_pool == NULL) || (_off == SHM_POOL__NULL) || (_off >= _pool->size)) {
+		return NULL;
+	}
+	return _pool->base + _off;
+}
+
+shm_off_t shm_pool__off(const struct shm_pool *_pool, const void *_mem)
+{
+	const uint8_t *mem = (const uint8_t*)_mem;
+
+	if ((_pool == NULL) || (mem <= _pool->base) || (mem >= (_pool->base + _pool->size))) {
+		return SHM_POOL__NULL;
+	}
+	return (shm_off_t)(mem - _pool->base);
+}
+
+size_t shm_pool__block_size(const struct shm_pool *_pool)
+{
+	if (_pool == NULL) {
+		return 0;
+	}
+	return (size_t)_pool->hdr->stride;
+}
+
+unsigned int shm_pool__available(const struct shm_pool *_pool)
+{
+	if (_pool == NULL) {
+		return 0;
+	}
+	return __atomic_load_n(&_pool->hdr->available, __ATOMIC_RELAXED);
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static int shm_pool__map(struct shm_pool **_pool, int _fd)
+{
+	struct shm_pool_hdr *hdr;
+	struct shm_pool *pool;
+	struct stat st;
+	uint8_t *base;
+	size_t size;
+
+	if (fstat(_fd, &st) != 0) {
+		return convert_std_errno(errno);
+	}
+	/* the creator has not sized the region yet */
+	if ((uint64_t)st.st_size < sizeof(struct shm_pool_hdr)) {
+		return -ESTD_AGAIN;
+	}
+	size = (size_t)st.st_size;
+
+	base = (uint8_t*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+	if ((void*)base == MAP_FAILED) {
+		return convert_std_errno(errno);
+	}
+
+	hdr = (struct shm_pool_hdr*)base;
+	if (__atomic_load_n(&hdr->magic, __ATOMIC_ACQUIRE) != SHM_POOL__MAGIC) {
+		munmap(base, size);
+		return -ESTD_AGAIN;
+	}
+	if ((hdr->version != SHM_POOL__VERSION) || (hdr->size != size) || (hdr->stride == 0) ||
+		(hdr->desc_offset < (ALIGN(sizeof(struct shm_pool_hdr), SHM_POOL__BLOCK_ALIGN) + sizeof(struct shm_pool_op) * SHM_POOL__OP_SLOTS)) ||
+		(hdr->desc_offset + ((uint64_t)hdr->blocks * sizeof(struct shm_pool_desc)) > hdr->data_offset) ||
+		(hdr->data_offset + (hdr->stride * hdr->blocks) > size)) {
+		munmap(base, size);
+		return -EPAR_INVCONFIG;
+	}
+
+	pool = (struct shm_pool*)alloc_memory(1, sizeof(struct shm_pool));
+	if (pool == NULL) {
+		munmap(base, size);
+		return -ESTD_NOMEM;
+	}
+	pool->base = base;
+	pool->size = size;
+	pool->fd = _fd;
+	pool->hdr = hdr;
+	pool->ops = (struct shm_pool_op*)(base + ALIGN(sizeof(struct shm_pool_hdr), SHM_POOL__BLOCK_ALIGN));
+	pool->desc = (struct shm_pool_desc*)(base + hdr->desc_offset);
+
+	*_pool = pool;
+	return EOK;
+}
+
+static int shm_pool__index(const struct shm_pool *_pool, shm_off_t _off, uint32_t *_index)
+{
+	const struct shm_pool_hdr *hdr = _pool->hdr;
+	uint64_t rel;
+
+	if (_off < hdr->data_offset) {
+		return -EPAR_RANGE;
+	}
+	rel = _off - hdr->data_offset;
+	if (((rel % hdr->stride) != 0) || ((rel / hdr->stride) >= hdr->blocks)) {
+		return -EPAR_RANGE;
+	}
+
+	*_index = (uint32_t)(rel / hdr->stride);
+	return EOK;
+}
+
+static void shm_pool__push(struct shm_pool *_pool, uint32_t _index)
+{
+	struct shm_pool_hdr *hdr = _pool->hdr;
+	uint64_t head, next;
+
+	head = __atomic_load_n(&hdr->free_head, __ATOMIC_RELAXED);
+	do {
+		__atomic_store_n(&_pool->desc[_index].next, SHM_POOL__HEAD_LINK(head), __ATOMIC_RELAXED);
+		next = SHM_POOL__HEAD(SHM_POOL__HEAD_TAG(head) + 1U, _index + 1U);
+	} while (!__atomic_compare_exchange_n(&hdr->free_head, &head, next, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+	__atomic_add_fetch(&hdr->available, 1, __ATOMIC_RELAXED);
+}
+
+static uint32_t shm_pool__enter(struct shm_pool *_pool)
+{
+	uint32_t self = shm_pool__self();
+	uint32_t slot = 0, n, pid;
+
+	for (;;) {
+		for (n = 0; n < SHM_POOL__OP_SLOTS; n++) {
+			slot = (s_op_hint + n) % SHM_POOL__OP_SLOTS;
+			pid = __atomic_load_n(&_pool->ops[slot].pid, __ATOMIC_RELAXED);
+			if ((pid == 0) &&
+				__atomic_compare_exchange_n(&_pool->ops[slot].pid, &pid, self, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+				break;
+			}
+			/* a slot of a killed process only tells that its block has to be found by the rebuild */
+			if ((pid != 0) && shm_pool__dead(pid)) {
+				__atomic_compare_exchange_n(&_pool->ops[slot].pid, &pid, 0, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+			}
+		}
+		if (n == SHM_POOL__OP_SLOTS) {
+			sched_yield();
+			continue;
+		}
+		s_op_hint = slot;
+
+		/* pairs with the scan of the slots in shm_pool__rebuild() */
+		pid = __atomic_load_n(&_pool->hdr->recover_pid, __ATOMIC_SEQ_CST);
+		if (pid == 0) {
+			return slot;
+		}
+		__atomic_store_n(&_pool->ops[slot].pid, 0, __ATOMIC_RELEASE);
+		if (shm_pool__dead(pid)) {
+			/* the recovering process was killed while the free list was rewritten */
+			shm_pool__recover(_pool);
+		}
+		else {
+			sched_yield();
+		}
+	}
+}
+
+static inline void shm_pool__leave(struct shm_pool *_pool, uint32_t _slot)
+{
+	__atomic_store_n(&_pool->ops[_slot].pid, 0, __ATOMIC_RELEASE);
+}
+
+static int shm_pool__rebuild(struct shm_pool *_pool)
+{
+	struct shm_pool_hdr *hdr = _pool->hdr;
+	uint32_t i, pid, link, listed = 0, count = 0;
+	uint32_t dead = 0, alive = 0;
+	uint64_t head;
+
+	/* wait until no live process is within alloc or free, killed ones never finish */
+	for (i = 0; i < SHM_POOL__OP_SLOTS; i++) {
+		while ((pid = __atomic_load_n(&_pool->ops[i].pid, __ATOMIC_SEQ_CST)) != 0) {
+			if (shm_pool__dead(pid)) {
+				__atomic_compare_exchange_n(&_pool->ops[i].pid, &pid, 0, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+			}
+			else {
+				sched_yield();
+			}
+		}
+	}
+
+	/* count the reachable blocks, a rebuild killed half way may have left a cycle */
+	head = __atomic_load_n(&hdr->free_head, __ATOMIC_ACQUIRE);
+	for (link = SHM_POOL__HEAD_LINK(head); (link != SHM_POOL__LINK_END) && (listed < hdr->blocks); listed++) {
+		link = _pool->desc[link - 1].next;
+	}
+
+	/*
+	 * Every block without a live owner is free. Adopting a block only
+	 * replaces an owner, so owners of 0 are stable while no operation runs.
+	 * Linking in descending order keeps every intermediate state acyclic.
+	 */
+	link = SHM_POOL__LINK_END;
+	for (i = hdr->blocks; i-- > 0;) {
+		pid = __atomic_load_n(&_pool->desc[i].owner, __ATOMIC_ACQUIRE);
+		if ((pid != 0) && (pid != alive)) {
+			if ((pid != dead) && !shm_pool__dead(pid)) {
+				alive = pid;
+				continue;
+			}
+			dead = pid;
+			if (!__atomic_compare_exchange_n(&_pool->desc[i].owner, &pid, 0, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+				continue;
+			}
+		}
+		else if (pid != 0) {
+			continue;
+		}
+		_pool->desc[i].next = link;
+		link = i + 1;
+		count++;
+	}
+
+	__atomic_store_n(&hdr->free_head, SHM_POOL__HEAD(SHM_POOL__HEAD_TAG(head) + 1U, link), __ATOMIC_SEQ_CST);
+	__atomic_store_n(&hdr->available, count, __ATOMIC_RELAXED);
+	return (count > listed) ? (int)(count - listed) : 0;
+}
+
+static int shm_pool__dead(uint32_t _pid)
+{
+#ifdef __linux__
+	char path[32], stat[128], *state;
+	ssize_t len;
+	int fd;
+#endif
+
+	if (kill((pid_t)_pid, 0) != 0) {
+		return (errno == ESRCH);
+	}
+
+#ifdef __linux__
+	/*
+	 * A killed process stays a zombie until its parent reaps it, kill()
+	 * still finds it. The state follows the command name, which may
+	 * contain ')' itself.
+	 */
+	snprintf(path, sizeof(path), "/proc/%u/stat", (unsigned int)_pid);
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return (errno == ENOENT);
+	}
+	len = read(fd, stat, sizeof(stat) - 1);
+	close(fd);
+	if (len <= 0) {
+		return 0;
+	}
+	stat[len] = '\0';
+	state = strrchr(stat, ')');
+	if ((state != NULL) && (state[1] == ' ')) {
+		return (state[2] == 'Z') || (state[2] == 'X');
+	}
+#endif
+	return 0;
+}
+
+static void shm_pool__pid_init(void)
+{
+	shm_pool__pid_update();
+	pthread_atfork(NULL, NULL, shm_pool__pid_update);
+}
+
+static void shm_pool__pid_update(void)
+{
+	__atomic_store_n(&s_pid, (uint32_t)getpid(), __ATOMIC_RELAXED);
+}
+
+static inline uint32_t shm_pool__self(void)
+{
+	pthread_once(&s_pid_once, shm_pool__pid_init);
+	return __atomic_load_n(&s_pid, __ATOMIC_RELAXED);
+}
+
+static int shm_pool__memfd(void)
+{
+#ifdef SYS_memfd_create
+	/* MFD_CLOEXEC, called through syscall() as older C libraries lack the wrapper */
+	return (int)syscall(SYS_memfd_create, "lib_convention__shm_pool", 1U);
+#else
+	errno = EOPNOTSUPP;
+	return -1;
+#endif
+}
@@ -0,0 +1,254 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <string.h>
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__mem.h>
+#include <lib_convention__slotmap.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define SLOTMAP__NONE		UINT32_MAX
+#define SLOTMAP__GEN_LIMIT	((uint32_t)(SLOTMAP__GEN_MASK >> SLOTMAP__INDEX_BITS))
+#define SLOTMAP__MIN_CAP	16U
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static int slotmap__grow(struct slotmap *_map, uint32_t _capacity);
+static inline struct slotmap_slot* slotmap__resolve(const struct slotmap *_map, slotmap_handle_t _handle);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int slotmap__init(struct slotmap *_map, size_t _elem_size, unsigned int _capacity)
+{
+	if (_map == NULL) {
+		return -EPAR_NULL;
+	}
+	if ((_elem_size == 0) || (_capacity > SLOTMAP__MAX_ENTRIES)) {
+		return -EPAR_RANGE;
+	}
+
+	memset(_map, 0, sizeof(*_map));
+	_map->elem_size = _elem_size;
+	_map->free_head = SLOTMAP__NONE;
+	_map->free_tail = SLOTMAP__NONE;
+	return slotmap__grow(_map, (_capacity < SLOTMAP__MIN_CAP) ? SLOTMAP__MIN_CAP : (uint32_t)_capacity);
+}
+
+int slotmap__destroy(struct slotmap *_map)
+{
+	if (_map == NULL) {
+		return -EPAR_NULL;
+	}
+
+	free_memory(_map->values);
+	free_memory(_map->owners);
+	free_memory(_map->slots);
+	memset(_map, 0, sizeof(*_map));
+	return EOK;
+}
+
+int slotmap__insert(struct slotmap *_map, const void *_value, slotmap_handle_t *_handle)
+{
+	struct slotmap_slot *slot;
+	uint32_t index, capacity;
+	int ret;
+
+	if ((_map == NULL) || (_handle == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	if (_map->count == _map->capacity) {
+		if (_map->capacity == SLOTMAP__MAX_ENTRIES) {
+			return -ELIST_OVERFLOW;
+		}
+		capacity = (_map->capacity > (SLOTMAP__MAX_ENTRIES / 2)) ? SLOTMAP__MAX_ENTRIES : (2 * _map->capacity);
+		ret = slotmap__grow(_map, capacity);
+		if (ret < EOK) {
+			return ret;
+		}
+	}
+
+	/* free slots are reused oldest first, which delays the wrap of their generation */
+	if (_map->free_head != SLOTMAP__NONE) {
+		index = _map->free_head;
+		slot = &_map->slots[index];
+		_map->free_head = slot->index;
+		if (_map->free_head == SLOTMAP__NONE) {
+			_map->free_tail = SLOTMAP__NONE;
+		}
+	}
+	else {
+		index = _map->slot_count++;
+		slot = &_map->slots[index];
+		slot->gen = 0;
+	}
+	slot->gen = (slot->gen + 1) & SLOTMAP__GEN_LIMIT;
+	slot->index = _map->count;
+
+	if (_value != NULL) {
+		memcpy(slotmap__at(_map, _map->count), _value, _map->elem_size);
+	}
+	else {
+		memset(slotmap__at(_map, _map->count), 0, _map->elem_size);
+	}
+	_map->owners[_map->count] = index;
+	_map->count++;
+
+	*_handle = ((slotmap_handle_t)slot->gen << SLOTMAP__INDEX_BITS) | (slotmap_handle_t)index;
+	return EOK;
+}
+
+int slotmap__erase(struct slotmap *_map, slotmap_handle_t _handle)
+{
+	struct slotmap_slot *slot;
+	uint32_t pos, last, index;
+
+	if (_map == NULL) {
+		return -EPAR_NULL;
+	}
+	slot = slotmap__resolve(_map, _handle);
+	if (slot == NULL) {
+		return -EPAR_INVCHN;
+	}
+
+	/* keep the values dense by moving the last entry into the gap */
+	pos = slot->index;
+	last = _map->count - 1;
+	if (pos != last) {
+		memcpy(slotmap__at(_map, pos), slotmap__at(_map, last), _map->elem_size);
+		_map->owners[pos] = _map->owners[last];
+		_map->slots[_map->owners[pos]].index = pos;
+	}
+	_map->count--;
+
+	index = (uint32_t)(_handle & SLOTMAP__INDEX_MASK);
+	slot->gen = (slot->gen + 1) & SLOTMAP__GEN_LIMIT;
+	slot->index = SLOTMAP__NONE;
+	if (_map->free_tail != SLOTMAP__NONE) {
+		_map->slots[_map->free_tail].index = index;
+	}
+	else {
+		_map->free_head = index;
+	}
+	_map->free_tail = index;
+	return EOK;
+}
+
+int slotmap__lookup(const struct slotmap *_map, slotmap_handle_t _handle, void **_value)
+{
+	struct slotmap_slot *slot;
+
+	if ((_map == NULL) || (_value == NULL)) {
+		return -EPAR_NULL;
+	}
+	slot = slotmap__resolve(_map, _handle);
+	if (slot == NULL) {
+		return -EPAR_INVCHN;
+	}
+
+	*_value = slotmap__at(_map, slot->index);
+	return EOK;
+}
+
+int slotmap__clear(struct slotmap *_map)
+{
+	if (_map == NULL) {
+		return -EPAR_NULL;
+	}
+
+	/* erasing the last entry moves nothing */
+	while (_map->count != 0) {
+		slotmap__erase(_map, slotmap__handle_at(_map, _map->count - 1));
+	}
+	return EOK;
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static int slotmap__grow(struct slotmap *_map, uint32_t _capacity)
+{
+	uint8_t *values;
+	uint32_t *owners;
+	struct slotmap_slot *slots;
+
+	if (_map->elem_size > (SIZE_MAX / _capacity)) {
+		return -ESTD_NOMEM;
+	}
+	values = (uint8_t*)alloc_memory(_capacity, _map->elem_size);
+	owners = (uint32_t*)alloc_memory(_capacity, sizeof(uint32_t));
+	slots = (struct slotmap_slot*)alloc_memory(_capacity, sizeof(struct slotmap_slot));
+	if ((values == NULL) || (owners == NULL) || (slots == NULL)) {
+		free_memory(values);
+		free_memory(owners);
+		free_memory(slots);
+		return -ESTD_NOMEM;
+	}
+
+	if (_map->values != NULL) {
+		memcpy(values, _map->values, (size_t)_map->count * _map->elem_size);
+		memcpy(owners, _map->owners, (size_t)_map->count * sizeof(uint32_t));
+		memcpy(slots, _map->slots, (size_t)_map->slot_count * sizeof(struct slotmap_slot));
+		free_memory(_map->values);
+		free_memory(_map->owners);
+		free_memory(_map->slots);
+	}
+	_map->values = values;
+	_map->owners = owners;
+	_map->slots = slots;
+	_map->capacity = _capacity;
+	return EOK;
+}
+
+static inline struct slotmap_slot* slotmap__resolve(const struct slotmap *_map, slotmap_handle_t _handle)
+{
+	uint32_t index = (uint32_t)(_handle & SLOTMAP__INDEX_MASK);
+	uint32_t gen = (uint32_t)((_handle & SLOTMAP__GEN_MASK) >> SLOTMAP__INDEX_BITS);
+	struct slotmap_slot *slot;
+
+	if (index >= _map->slot_count) {
+		return NULL;
+	}
+	slot = &_map->slots[index];
+	if ((slot->gen != gen) || !(gen & 1U)) {
+		return NULL;
+	}
+	return slot;
+}
@@ -0,0 +1,978 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdlib.h>
+#include <string.h>
+
+/* system */
+#include <pthread.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+/* own libs */
+#include <lib_convention__macro.h>
+
+/* project */
+#include "lib_convention__tcache.h"
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* Size of the memory regions the central heap carves blocks from */
+#define TCACHE__SPAN_SIZE		(256U * 1024U)
+
+/* Number of bytes moved between a thread cache and the central heap at once */
+#define TCACHE__BATCH_BYTES		(16U * 1024U)
+#define TCACHE__BATCH_MIN		4U
+#define TCACHE__BATCH_MAX		64U
+
+/* Number of 16 byte spaced classes at the start of the class table */
+#define TCACHE__CLASS_LINEAR	15U
+#define TCACHE__LINEAR_LIMIT	256U
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* Free block, the link is stored in the user area behind the header */
+struct tcache_block {
+	struct tcache_block *next;
+};
+
+/* Per-thread list of free blocks of one size class */
+struct tcache_bin {
+	struct tcache_block *head;
+	uint32_t count;
+};
+
+/* Per-thread cache of all size classes */
+struct tcache {
+	struct tcache_bin bin[TCACHE__CLASS_COUNT];
+	int registered;
+};
+
+/*
+ * Shared lists of free blocks and the span currently carved for one class.
+ * Released blocks enter free, each decay step moves them on to aged and
+ * then purges their pages into clean.
+ */
+struct tcache_central {
+	pthread_mutex_t lock;
+	struct tcache_block *free;
+	struct tcache_block *aged;
+	struct tcache_block *clean;
+	char *span_cur;
+	char *span_end;
+};
+
+/* Released TCACHE__CLASS_MAPPED block, stored at the start of its header page */
+struct tcache_mapping {
+	struct tcache_mapping *next;
+	size_t len;
+	int lazy;
+};
+
+/* Released mappings kept for reuse, they age like the central free lists */
+struct tcache_mapcache {
+	pthread_mutex_t lock;
+	struct tcache_mapping *free;
+	struct tcache_mapping *aged;
+	struct tcache_mapping *clean;
+};
+
+/* *******************************************************************
+ * (static) variables declarations
+ * ******************************************************************/
+
+/* Block sizes including the header: 16 byte steps up to 256, then 4 classes per power of two */
+static const uint32_t s_class_size[TCACHE__CLASS_COUNT] = {
+	   32,    48,    64,    80,    96,   112,   128,   144,
+	  160,   176,   192,   208,   224,   240,   256,
+	  320,   384,   448,   512,   640,   768,   896,  1024,
+	 1280,  1536,  1792,  2048,  2560,  3072,  3584,  4096,
+	 5120,  6144,  7168,  8192, 10240, 12288, 14336, 16384,
+	20480, 24576, 28672, 32768
+};
+
+static struct tcache_central s_central[TCACHE__CLASS_COUNT];
+static pthread_once_t s_central_once = PTHREAD_ONCE_INIT;
+static pthread_key_t s_thread_key;
+static size_t s_page;
+
+static struct tcache_mapcache s_mapcache = { PTHREAD_MUTEX_INITIALIZER, NULL, NULL, NULL };
+
+/* purge configuration, see tcache__purge_configure() */
+static uint64_t s_decay_ms = TCACHE__DECAY_MS;
+static uint64_t s_decay_next;
+static size_t s_ceiling = SIZE_MAX;
+static int s_lazy;
+
+/* purge statistics, retained counts the dirty bytes a purge could return */
+static size_t s_retained_bytes;
+static uint64_t s_purged_bytes;
+static uint64_t s_unmapped_bytes;
+static uint64_t s_purge_runs;
+static pthread_mutex_t s_purge_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static __thread struct tcache s_tcache;
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static void tcache__init(void);
+static void tcache__register(void);
+static void tcache__thread_exit(void *_arg);
+static inline uint32_t tcache__class_of(size_t _block);
+static inline uint32_t tcache__batch(uint32_t _cls);
+static uint32_t central__refill(uint32_t _cls, struct tcache_bin *_bin, uint32_t _count);
+static void central__release(uint32_t _cls, struct tcache_block *_head, struct tcache_block *_tail, uint32_t _count);
+static void central__purge(uint32_t _cls, unsigned int _flags);
+static inline int central__purgeable(uint32_t _cls);
+static void* mapcache__take(size_t _size, size_t _align);
+static void mapcache__put(void *_map, size_t _len);
+static void mapcache__purge(unsigned int _flags);
+static size_t tcache__advise(char *_start, char *_end, int _lazy);
+static void tcache__retain_check(void);
+static void tcache__purge_locked(unsigned int _flags);
+static uint64_t tcache__now_ms(void);
+static inline void* tcache__take(size_t _size, int _zero);
+static inline void tcache__put(uint32_t _cls, void *_mem);
+static void* tcache__alloc_large(size_t _size, int _zero);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+void* tcache__alloc(size_t _size)
+{
+	return tcache__take(_size, 1);
+}
+
+void* tcache__alloc_uninit(size_t _size)
+{
+	return tcache__take(_size, 0);
+}
+
+void tcache__free(void *_mem)
+{
+	struct tcache_hdr *hdr;
+
+	if (_mem == NULL) {
+		return;
+	}
+
+	hdr = (struct tcache_hdr*)((char*)_mem - TCACHE__HDR_SIZE);
+	if (hdr->cls >= TCACHE__CLASS_MAPPED) {
+		switch (hdr->cls) {
+			case TCACHE__CLASS_LARGE:
+				free((char*)hdr - hdr->offset);
+				break;
+			case TCACHE__CLASS_ALIGNED:
+				tcache__free((char*)hdr - hdr->offset);
+				break;
+			default:
+				mapcache__put((char*)hdr - hdr->offset, (size_t)hdr->size);
+				break;
+		}
+		return;
+	}
+
+	tcache__put(hdr->cls, _mem);
+}
+
+int tcache__alloc_bulk(size_t _size, void **_mem, unsigned int _count)
+{
+	struct tcache_bin *bin;
+	struct tcache_block *blk;
+	unsigned int i;
+	uint32_t cls, need;
+
+	if (_size > (TCACHE__MAX_BLOCK - TCACHE__HDR_SIZE)) {
+		for (i = 0; i < _count; i++) {
+			_mem[i] = tcache__alloc_large(_size, 1);
+			if (_mem[i] == NULL) {
+				tcache__free_bulk(_mem, i);
+				return -1;
+			}
+		}
+		return 0;
+	}
+
+	cls = tcache__class_of(_size + TCACHE__HDR_SIZE);
+	bin = &s_tcache.bin[cls];
+	if (bin->count < _count) {
+		if (!s_tcache.registered) {
+			tcache__register();
+		}
+		/* a single trip to the central heap for the whole batch */
+		need = _count - bin->count;
+		if (need < tcache__batch(cls)) {
+			need = tcache__batch(cls);
+		}
+		central__refill(cls, bin, need);
+		if (bin->count < _count) {
+			return -1;
+		}
+	}
+
+	for (i = 0; i < _count; i++) {
+		blk = bin->head;
+		bin->head = blk->next;
+		memset(blk, 0, _size);
+		_mem[i] = blk;
+	}
+	bin->count -= _count;
+	return 0;
+}
+
+void tcache__free_bulk(void **_mem, unsigned int _count)
+{
+	struct tcache_hdr *hdr;
+	struct tcache_bin *bin;
+	struct tcache_block *blk, *tail;
+	uint64_t touched = 0;
+	uint32_t cls, batch, n, i;
+	unsigned int k;
+
+	if (!s_tcache.registered) {
+		tcache__register();
+	}
+
+	for (k = 0; k < _count; k++) {
+		if (_mem[k] == NULL) {
+			continue;
+		}
+		hdr = (struct tcache_hdr*)((char*)_mem[k] - TCACHE__HDR_SIZE);
+		if (hdr->cls >= TCACHE__CLASS_COUNT) {
+			tcache__free(_mem[k]);
+			continue;
+		}
+		bin = &s_tcache.bin[hdr->cls];
+		blk = (struct tcache_block*)_mem[k];
+		blk->next = bin->head;
+		bin->head = blk;
+		bin->count++;
+		touched |= 1ULL << hdr->cls;
+	}
+
+	/* trim every touched bin with a single trip to the central heap */
+	while (touched != 0) {
+		cls = (uint32_t)__builtin_ctzll(touched);
+		touched &= touched - 1;
+
+		bin = &s_tcache.bin[cls];
+		batch = tcache__batch(cls);
+		if (bin->count <= (2 * batch)) {
+			continue;
+		}
+		n = bin->count - batch;
+		tail = bin->head;
+		for (i = 1; i < n; i++) {
+			tail = tail->next;
+		}
+		blk = bin->head;
+		bin->head = tail->next;
+		bin->count = batch;
+		central__release(cls, blk, tail, n);
+	}
+}
+
+void tcache__free_sized(void *_mem, size_t _size)
+{
+	if (_mem == NULL) {
+		return;
+	}
+
+	/* the class follows from the size, the header does not have to be loaded */
+	if (_size <= (TCACHE__MAX_BLOCK - TCACHE__HDR_SIZE)) {
+		tcache__put(tcache__class_of(_size + TCACHE__HDR_SIZE), _mem);
+		return;
+	}
+	tcache__free(_mem);
+}
+
+void* tcache__realloc(void *_mem, size_t _size)
+{
+	struct tcache_hdr *hdr, *raw;
+	size_t old;
+	void *mem;
+
+	if (_mem == NULL) {
+		return tcache__alloc_uninit(_size);
+	}
+
+	/* blocks stay in the class of their last requested size, see tcache__free_sized() */
+	hdr = (struct tcache_hdr*)((char*)_mem - TCACHE__HDR_SIZE);
+	if ((hdr->cls < TCACHE__CLASS_COUNT) && (_size <= (TCACHE__MAX_BLOCK - TCACHE__HDR_SIZE)) &&
+		(tcache__class_of(_size + TCACHE__HDR_SIZE) == hdr->cls)) {
+		return _mem;
+	}
+
+	if ((hdr->cls == TCACHE__CLASS_LARGE) && (_size > (TCACHE__MAX_BLOCK - TCACHE__HDR_SIZE)) &&
+		(_size < TCACHE__MAP_THRESHOLD)) {
+		raw = (struct tcache_hdr*)realloc((char*)hdr - hdr->offset, _size + TCACHE__HDR_SIZE);
+		if (raw == NULL) {
+			return NULL;
+		}
+		raw->offset = 0;
+		raw->size = _size;
+		return (char*)raw + TCACHE__HDR_SIZE;
+	}
+
+	mem = tcache__alloc_uninit(_size);
+	if (mem == NULL) {
+		return NULL;
+	}
+	old = tcache__usable_size(_mem);
+	memcpy(mem, _mem, (old < _size) ? old : _size);
+	tcache__free(_mem);
+	return mem;
+}
+
+void* tcache__alloc_aligned(size_t _size, size_t _align)
+{
+	struct tcache_hdr *hdr;
+	uintptr_t raw, mem;
+
+	if (_align <= TCACHE__HDR_SIZE) {
+		return tcache__alloc(_size);
+	}
+	if (((_align & (_align - 1)) != 0) || (_align > UINT32_MAX) || (_size > (SIZE_MAX - _align))) {
+		return NULL;
+	}
+
+	/* the underlying block is 16 byte aligned, which leaves room for a second header */
+	raw = (uintptr_t)tcache__alloc(_size + _align);
+	if (raw == 0) {
+		return NULL;
+	}
+	mem = ALIGN(raw + TCACHE__HDR_SIZE, (uintptr_t)_align);
+
+	hdr = (struct tcache_hdr*)(mem - TCACHE__HDR_SIZE);
+	hdr->cls = TCACHE__CLASS_ALIGNED;
+	hdr->offset = (uint32_t)((uintptr_t)hdr - raw);
+	hdr->size = _size;
+	return (void*)mem;
+}
+
+void* tcache__alloc_mapped(size_t _size)
+{
+	struct tcache_hdr *hdr;
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	size_t align = (_size >= TCACHE__HUGE_PAGE) ? TCACHE__HUGE_PAGE : page;
+	size_t len, head, tail;
+	uintptr_t map, mem;
+	void *reused;
+
+	if (_size > (SIZE_MAX - align - (2 * page))) {
+		return NULL;
+	}
+
+	/* a mapping released before saves the page faults of a fresh one */
+	reused = mapcache__take(_size, align);
+	if (reused != NULL) {
+		return reused;
+	}
+
+	/* one page in front of the block carries the header */
+	len = ALIGN(_size, page) + page + (align - page);
+	map = (uintptr_t)mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if ((void*)map == MAP_FAILED) {
+		return NULL;
+	}
+
+	/* trim the slack used to reach huge page alignment */
+	mem = ALIGN(map + page, (uintptr_t)align);
+	head = (size_t)(mem - page - map);
+	tail = len - head - page - ALIGN(_size, page);
+	if (head != 0) {
+		munmap((void*)map, head);
+	}
+	if (tail != 0) {
+		munmap((void*)(map + len - tail), tail);
+	}
+	len -= head + tail;
+
+#ifdef MADV_HUGEPAGE
+	if (align == TCACHE__HUGE_PAGE) {
+		madvise((void*)mem, ALIGN(_size, page), MADV_HUGEPAGE);
+	}
+#endif
+
+	hdr = (struct tcache_hdr*)(mem - TCACHE__HDR_SIZE);
+	hdr->cls = TCACHE__CLASS_MAPPED;
+	hdr->offset = (uint32_t)(page - TCACHE__HDR_SIZE);
+	hdr->size = len;
+	return (void*)mem;
+}
+
+size_t tcache__usable_size(const void *_mem)
+{
+	const struct tcache_hdr *hdr = (const struct tcache_hdr*)((const char*)_mem - TCACHE__HDR_SIZE);
+
+	if (hdr->cls < TCACHE__CLASS_COUNT) {
+		return s_class_size[hdr->cls] - TCACHE__HDR_SIZE;
+	}
+	if (hdr->cls == TCACHE__CLASS_MAPPED) {
+		return (size_t)hdr->size - hdr->offset - TCACHE__HDR_SIZE;
+	}
+	return (size_t)hdr->size;
+}
+
+void tcache__purge(unsigned int _flags)
+{
+	pthread_mutex_lock(&s_purge_lock);
+	tcache__purge_locked(_flags);
+	pthread_mutex_unlock(&s_purge_lock);
+}
+
+void tcache__purge_tick(void)
+{
+	uint64_t decay = __atomic_load_n(&s_decay_ms, __ATOMIC_RELAXED);
+	uint64_t next = __atomic_load_n(&s_decay_next, __ATOMIC_RELAXED);
+	uint64_t now;
+
+	if (decay == 0) {
+		return;
+	}
+	now = tcache__now_ms();
+	if (now < next) {
+		return;
+	}
+
+	/* a single context runs the step, the others carry on allocating */
+	if (!__atomic_compare_exchange_n(&s_decay_next, &next, now + decay, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		return;
+	}
+	if (pthread_mutex_trylock(&s_purge_lock) == 0) {
+		tcache__purge_locked(0);
+		pthread_mutex_unlock(&s_purge_lock);
+	}
+}
+
+void tcache__purge_configure(unsigned int _decay_ms, size_t _ceiling, int _lazy)
+{
+	__atomic_store_n(&s_decay_ms, (uint64_t)_decay_ms, __ATOMIC_RELAXED);
+	__atomic_store_n(&s_ceiling, _ceiling, __ATOMIC_RELAXED);
+	__atomic_store_n(&s_lazy, _lazy, __ATOMIC_RELAXED);
+	__atomic_store_n(&s_decay_next, 0, __ATOMIC_RELAXED);
+
+	if (_decay_ms == 0) {
+		tcache__purge(TCACHE__PURGE_DIRTY | TCACHE__PURGE_UNMAP);
+	}
+}
+
+void tcache__purge_stats(struct mem_purge_stats *_stats)
+{
+	_stats->retained_bytes = __atomic_load_n(&s_retained_bytes, __ATOMIC_RELAXED);
+	_stats->purged_bytes = __atomic_load_n(&s_purged_bytes, __ATOMIC_RELAXED);
+	_stats->unmapped_bytes = __atomic_load_n(&s_unmapped_bytes, __ATOMIC_RELAXED);
+	_stats->runs = __atomic_load_n(&s_purge_runs, __ATOMIC_RELAXED);
+}
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static inline void* tcache__take(size_t _size, int _zero)
+{
+	struct tcache_bin *bin;
+	struct tcache_block *blk;
+	uint32_t cls;
+
+	if (_size > (TCACHE__MAX_BLOCK - TCACHE__HDR_SIZE)) {
+		return tcache__alloc_large(_size, _zero);
+	}
+
+	cls = tcache__class_of(_size + TCACHE__HDR_SIZE);
+	bin = &s_tcache.bin[cls];
+	blk = bin->head;
+	if (blk == NULL) {
+		if (!s_tcache.registered) {
+			tcache__register();
+		}
+		if (central__refill(cls, bin, tcache__batch(cls)) == 0) {
+			return NULL;
+		}
+		blk = bin->head;
+	}
+
+	bin->head = blk->next;
+	bin->count--;
+	if (_zero) {
+		memset(blk, 0, _size);
+	}
+	return blk;
+}
+
+static inline void tcache__put(uint32_t _cls, void *_mem)
+{
+	struct tcache_bin *bin;
+	struct tcache_block *blk, *tail;
+	uint32_t batch, i;
+
+	if (!s_tcache.registered) {
+		tcache__register();
+	}
+
+	bin = &s_tcache.bin[_cls];
+	blk = (struct tcache_block*)_mem;
+	blk->next = bin->head;
+	bin->head = blk;
+	bin->count++;
+
+	batch = tcache__batch(_cls);
+	if (bin->count <= (2 * batch)) {
+		return;
+	}
+
+	/* hand the most recently freed batch back, keep the rest hot */
+	tail = bin->head;
+	for (i = 1; i < batch; i++) {
+		tail = tail->next;
+	}
+	blk = bin->head;
+	bin->head = tail->next;
+	bin->count -= batch;
+	central__release(_cls, blk, tail, batch);
+}
+
+static void tcache__init(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < TCACHE__CLASS_COUNT; i++) {
+		pthread_mutex_init(&s_central[i].lock, NULL);
+	}
+	pthread_key_create(&s_thread_key, tcache__thread_exit);
+	s_page = (size_t)sysconf(_SC_PAGESIZE);
+}
+
+static void tcache__register(void)
+{
+	pthread_once(&s_central_once, tcache__init);
+	pthread_setspecific(s_thread_key, &s_tcache);
+	s_tcache.registered = 1;
+}
+
+static void tcache__thread_exit(void *_arg)
+{
+	struct tcache *cache = (struct tcache*)_arg;
+	struct tcache_block *tail;
+	uint32_t cls, count;
+
+	for (cls = 0; cls < TCACHE__CLASS_COUNT; cls++) {
+		tail = cache->bin[cls].head;
+		if (tail == NULL) {
+			continue;
+		}
+		for (count = 1; tail->next != NULL; count++) {
+			tail = tail->next;
+		}
+		central__release(cls, cache->bin[cls].head, tail, count);
+		cache->bin[cls].head = NULL;
+		cache->bin[cls].count = 0;
+	}
+	/* a later free from another TLS destructor registers the cache again */
+	cache->registered = 0;
+}
+
+static inline uint32_t tcache__class_of(size_t _block)
+{
+	uint32_t t, p;
+
+	if (_block <= TCACHE__LINEAR_LIMIT) {
+		t = (uint32_t)((_block + 15U) >> 4);
+		return (t < 2U) ? 0U : (t - 2U);
+	}
+
+	/* four classes per power of two above the linear range */
+	t = (uint32_t)_block - 1U;
+	p = 31U - (uint32_t)__builtin_clz(t);
+	return TCACHE__CLASS_LINEAR + ((p - 8U) * 4U) + ((t >> (p - 2U)) & 3U);
+}
+
+static inline uint32_t tcache__batch(uint32_t _cls)
+{
+	uint32_t batch = TCACHE__BATCH_BYTES / s_class_size[_cls];
+
+	if (batch < TCACHE__BATCH_MIN) {
+		return TCACHE__BATCH_MIN;
+	}
+	if (batch > TCACHE__BATCH_MAX) {
+		return TCACHE__BATCH_MAX;
+	}
+	return batch;
+}
+
+static uint32_t central__refill(uint32_t _cls, struct tcache_bin *_bin, uint32_t _count)
+{
+	struct tcache_central *central = &s_central[_cls];
+	struct tcache_block *blk, **list;
+	struct tcache_hdr *hdr;
+	uint32_t size = s_class_size[_cls];
+	uint32_t got = 0, dirty = 0;
+	void *span;
+
+	pthread_mutex_lock(&central->lock);
+
+	/* recently released blocks first, their pages are still resident */
+	for (list = &central->free; got < _count; ) {
+		if (*list == NULL) {
+			if (list == &central->free) {
+				list = &central->aged;
+			}
+			else if (list == &central->aged) {
+				list = &central->clean;
+			}
+			else {
+				break;
+			}
+			continue;
+		}
+		blk = *list;
+		*list = blk->next;
+		blk->next = _bin->head;
+		_bin->head = blk;
+		dirty += (list != &central->clean) ? 1U : 0U;
+		got++;
+	}
+
+	while (got < _count) {
+		if ((size_t)(central->span_end - central->span_cur) < size) {
+			span = mmap(NULL, TCACHE__SPAN_SIZE, PROT_READ | PROT_WRITE,
+						MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (span == MAP_FAILED) {
+				break;
+			}
+			central->span_cur = (char*)span;
+			central->span_end = (char*)span + TCACHE__SPAN_SIZE;
+		}
+
+		hdr = (struct tcache_hdr*)central->span_cur;
+		hdr->cls = _cls;
+		hdr->offset = 0;
+		hdr->size = size - TCACHE__HDR_SIZE;
+		central->span_cur += size;
+
+		blk = (struct tcache_block*)((char*)hdr + TCACHE__HDR_SIZE);
+		blk->next = _bin->head;
+		_bin->head = blk;
+		got++;
+	}
+
+	pthread_mutex_unlock(&central->lock);
+
+	if ((dirty != 0) && central__purgeable(_cls)) {
+		__atomic_sub_fetch(&s_retained_bytes, (size_t)dirty * size, __ATOMIC_RELAXED);
+	}
+	_bin->count += got;
+	return got;
+}
+
+static void central__release(uint32_t _cls, struct tcache_block *_head, struct tcache_block *_tail, uint32_t _count)
+{
+	struct tcache_central *central = &s_central[_cls];
+
+	pthread_mutex_lock(&central->lock);
+	_tail->next = central->free;
+	central->free = _head;
+	pthread_mutex_unlock(&central->lock);
+
+	if (central__purgeable(_cls)) {
+		__atomic_add_fetch(&s_retained_bytes, (size_t)_count * s_class_size[_cls], __ATOMIC_RELAXED);
+		tcache__retain_check();
+	}
+}
+
+static void* tcache__alloc_large(size_t _size, int _zero)
+{
+	struct tcache_hdr *hdr;
+
+	if (_size >= TCACHE__MAP_THRESHOLD) {
+		return tcache__alloc_mapped(_size);
+	}
+
+	if (_zero) {
+		hdr = (struct tcache_hdr*)calloc(1, _size + TCACHE__HDR_SIZE);
+	}
+	else {
+		hdr = (struct tcache_hdr*)malloc(_size + TCACHE__HDR_SIZE);
+	}
+	if (hdr == NULL) {
+		return NULL;
+	}
+	hdr->cls = TCACHE__CLASS_LARGE;
+	hdr->offset = 0;
+	hdr->size = _size;
+	return (char*)hdr + TCACHE__HDR_SIZE;
+}
+
+static inline int central__purgeable(uint32_t _cls)
+{
+	/* smaller blocks rarely cover a whole page besides the one of their link */
+	return s_class_size[_cls] >= (2 * s_page);
+}
+
+static void central__purge(uint32_t _cls, unsigned int _flags)
+{
+	struct tcache_central *central = &s_central[_cls];
+	struct tcache_block *lists[2], *blk, *next, *head = NULL, *tail = NULL;
+	uint32_t size = s_class_size[_cls];
+	int lazy = __atomic_load_n(&s_lazy, __ATOMIC_RELAXED);
+	size_t purged = 0, count = 0;
+	unsigned int i;
+
+	pthread_mutex_lock(&central->lock);
+	lists[0] = central->aged;
+	lists[1] = NULL;
+	if (_flags & TCACHE__PURGE_DIRTY) {
+		lists[1] = central->free;
+		central->aged = NULL;
+	}
+	else {
+		central->aged = central->free;
+	}
+	central->free = NULL;
+	pthread_mutex_unlock(&central->lock);
+
+	/* the page holding the header and the link stays resident */
+	for (i = 0; i < 2; i++) {
+		for (blk = lists[i]; blk != NULL; blk = next) {
+			next = blk->next;
+			purged += tcache__advise((char*)blk + sizeof(struct tcache_block),
+									 (char*)blk - TCACHE__HDR_SIZE + size, lazy);
+			blk->next = head;
+			head = blk;
+			if (tail == NULL) {
+				tail = blk;
+			}
+			count++;
+		}
+	}
+	if (head == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&central->lock);
+	tail->next = central->clean;
+	central->clean = head;
+	pthread_mutex_unlock(&central->lock);
+
+	__atomic_sub_fetch(&s_retained_bytes, count * size, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&s_purged_bytes, (uint64_t)purged, __ATOMIC_RELAXED);
+}
+
+static void* mapcache__take(size_t _size, size_t _align)
+{
+	struct tcache_mapping **lists[3] = { &s_mapcache.free, &s_mapcache.aged, &s_mapcache.clean };
+	struct tcache_mapping **link, *map = NULL;
+	struct tcache_hdr *hdr;
+	size_t need, avail = 0;
+	unsigned int i;
+	uintptr_t mem = 0;
+	int dirty = 0;
+
+	pthread_once(&s_central_once, tcache__init);
+	need = ALIGN(_size, s_page);
+
+	pthread_mutex_lock(&s_mapcache.lock);
+	for (i = 0; (i < 3) && (map == NULL); i++) {
+		for (link = lists[i]; *link != NULL; link = &(*link)->next) {
+			avail = (*link)->len - s_page;
+			mem = (uintptr_t)*link + s_page;
+			/* do not waste more than the requested size */
+			if ((avail >= need) && (avail <= (2 * need)) && ((mem & (_align - 1)) == 0)) {
+				map = *link;
+				*link = map->next;
+				dirty = (lists[i] != &s_mapcache.clean);
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&s_mapcache.lock);
+
+	if (map == NULL) {
+		return NULL;
+	}
+
+	/* pages purged with MADV_DONTNEED are zero filled again by the kernel */
+	if (dirty || map->lazy) {
+		memset((void*)mem, 0, _size);
+	}
+	if (dirty) {
+		__atomic_sub_fetch(&s_retained_bytes, avail, __ATOMIC_RELAXED);
+	}
+
+	hdr = (struct tcache_hdr*)(mem - TCACHE__HDR_SIZE);
+	hdr->cls = TCACHE__CLASS_MAPPED;
+	hdr->offset = (uint32_t)(s_page - TCACHE__HDR_SIZE);
+	hdr->size = map->len;
+	return (void*)mem;
+}
+
+static void mapcache__put(void *_map, size_t _len)
+{
+	struct tcache_mapping *map = (struct tcache_mapping*)_map;
+
+	pthread_once(&s_central_once, tcache__init);
+	if (__atomic_load_n(&s_decay_ms, __ATOMIC_RELAXED) == 0) {
+		munmap(_map, _len);
+		return;
+	}
+
+	map->len = _len;
+	map->lazy = 0;
+	pthread_mutex_lock(&s_mapcache.lock);
+	map->next = s_mapcache.free;
+	s_mapcache.free = map;
+	pthread_mutex_unlock(&s_mapcache.lock);
+
+	__atomic_add_fetch(&s_retained_bytes, _len - s_page, __ATOMIC_RELAXED);
+	tcache__retain_check();
+}
+
+static void mapcache__purge(unsigned int _flags)
+{
+	struct tcache_mapping *lists[2], *unmap, *map, *next;
+	int lazy = __atomic_load_n(&s_lazy, __ATOMIC_RELAXED);
+	size_t purged = 0, retained = 0, unmapped = 0;
+	unsigned int i;
+
+	pthread_mutex_lock(&s_mapcache.lock);
+	/* purged on an earlier step and still not reused */
+	unmap = NULL;
+	if ((_flags == 0) || (_flags & TCACHE__PURGE_UNMAP)) {
+		unmap = s_mapcache.clean;
+		s_mapcache.clean = NULL;
+	}
+	lists[0] = s_mapcache.aged;
+	lists[1] = NULL;
+	if (_flags & TCACHE__PURGE_DIRTY) {
+		lists[1] = s_mapcache.free;
+		s_mapcache.aged = NULL;
+	}
+	else {
+		s_mapcache.aged = s_mapcache.free;
+	}
+	s_mapcache.free = NULL;
+	pthread_mutex_unlock(&s_mapcache.lock);
+
+	for (i = 0; i < 2; i++) {
+		for (map = lists[i]; map != NULL; map = next) {
+			next = map->next;
+			retained += map->len - s_page;
+			if (_flags & TCACHE__PURGE_UNMAP) {
+				map->next = unmap;
+				unmap = map;
+				continue;
+			}
+			purged += tcache__advise((char*)map + s_page, (char*)map + map->len, lazy);
+			map->lazy = lazy;
+			pthread_mutex_lock(&s_mapcache.lock);
+			map->next = s_mapcache.clean;
+			s_mapcache.clean = map;
+			pthread_mutex_unlock(&s_mapcache.lock);
+		}
+	}
+
+	for (map = unmap; map != NULL; map = next) {
+		next = map->next;
+		unmapped += map->len;
+		munmap(map, map->len);
+	}
+
+	__atomic_sub_fetch(&s_retained_bytes, retained, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&s_purged_bytes, (uint64_t)purged, __ATOMIC_RELAXED);
+	__atomic_add_fetch(&s_unmapped_bytes, (uint64_t)unmapped, __ATOMIC_RELAXED);
+}
+
+static size_t tcache__advise(char *_start, char *_end, int _lazy)
+{
+	uintptr_t start = ALIGN((uintptr_t)_start, (uintptr_t)s_page);
+	uintptr_t end = (uintptr_t)_end & ~((uintptr_t)s_page - 1);
+	int advice = MADV_DONTNEED;
+
+	if (end <= start) {
+		return 0;
+	}
+#ifdef MADV_FREE
+	if (_lazy) {
+		advice = MADV_FREE;
+	}
+#else
+	(void)_lazy;
+#endif
+	if (madvise((void*)start, end - start, advice) != 0) {
+		return 0;
+	}
+	return end - start;
+}
+
+static void tcache__retain_check(void)
+{
+	if ((__atomic_load_n(&s_retained_bytes, __ATOMIC_RELAXED) > __atomic_load_n(&s_ceiling, __ATOMIC_RELAXED)) ||
+		(__atomic_load_n(&s_decay_ms, __ATOMIC_RELAXED) == 0)) {
+		/* above the ceiling nothing dirty is kept, whatever its age */
+		if (pthread_mutex_trylock(&s_purge_lock) == 0) {
+			tcache__purge_locked(TCACHE__PURGE_DIRTY);
+			pthread_mutex_unlock(&s_purge_lock);
+		}
+		return;
+	}
+	tcache__purge_tick();
+}
+
+static void tcache__purge_locked(unsigned int _flags)
+{
+	uint32_t cls;
+
+	pthread_once(&s_central_once, tcache__init);
+	for (cls = 0; cls < TCACHE__CLASS_COUNT; cls++) {
+		if (central__purgeable(cls)) {
+			central__purge(cls, _flags);
+		}
+	}
+	mapcache__purge(_flags);
+	__atomic_add_fetch(&s_purge_runs, 1, __ATOMIC_RELAXED);
+}
+
+static uint64_t tcache__now_ms(void)
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC_COARSE
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+	return ((uint64_t)ts.tv_sec * 1000U) + ((uint64_t)ts.tv_nsec / 1000000U);
+}
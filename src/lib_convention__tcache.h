@@ -0,0 +1,250 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef LIB_CONVENTION__TCACHE_H_
+#define LIB_CONVENTION__TCACHE_H_
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+#include <stddef.h>
+
+/* own libs */
+#include <lib_convention__mem_purge.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Size of the block header which precedes every user pointer.
+ *
+ * 	Keeps the user pointer aligned to 16 bytes, which is the alignment
+ * 	guaranteed by calloc() on the supported unix targets.
+ * ****************************************************************************/
+#define TCACHE__HDR_SIZE		16U
+
+/* ************************************************************************//**
+ * \brief	Number of segregated size classes and the largest block size
+ * 			(header included) served from the thread caches
+ * ****************************************************************************/
+#define TCACHE__CLASS_COUNT		43U
+#define TCACHE__MAX_BLOCK		32768U
+
+/* ************************************************************************//**
+ * \brief	Class markers of blocks which are not taken from a size class
+ *
+ * 	TCACHE__CLASS_LARGE		: served directly by calloc()
+ * 	TCACHE__CLASS_ALIGNED	: aligned pointer inside of another tcache block
+ * 	TCACHE__CLASS_MAPPED	: private anonymous mapping, released by munmap()
+ * ****************************************************************************/
+#define TCACHE__CLASS_LARGE		0xFFFFFFFFU
+#define TCACHE__CLASS_ALIGNED	0xFFFFFFFEU
+#define TCACHE__CLASS_MAPPED	0xFFFFFFFDU
+
+/* ************************************************************************//**
+ * \brief	Requests of at least this size are served by TCACHE__CLASS_MAPPED
+ * 			blocks, which are backed by transparent huge pages if possible
+ * ****************************************************************************/
+#define TCACHE__MAP_THRESHOLD	(1024U * 1024U)
+#define TCACHE__HUGE_PAGE		(2U * 1024U * 1024U)
+
+/* ************************************************************************//**
+ * \brief	Default decay period of the retained free memory in milliseconds
+ * ****************************************************************************/
+#define TCACHE__DECAY_MS		10000U
+
+/* ************************************************************************//**
+ * \brief	Flags of tcache__purge()
+ *
+ * 	0						: one decay step, aged memory is purged, freed
+ * 							  memory ages and mappings purged by the last
+ * 							  step are unmapped
+ * 	TCACHE__PURGE_DIRTY		: purge all freed memory regardless of its age
+ * 	TCACHE__PURGE_UNMAP		: unmap all released mappings
+ * ****************************************************************************/
+#define TCACHE__PURGE_DIRTY		0x1U
+#define TCACHE__PURGE_UNMAP		0x2U
+
+/* *******************************************************************
+ * custom data types (e.g. enumerations, structures, unions)
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Block header
+ *
+ * 	Located immediately in front of every pointer handed out by
+ * 	tcache__alloc(). It allows tcache__free() to find the size class of
+ * 	a block without any lookup.
+ *
+ * \param	cls		: size class index or one of the TCACHE__CLASS_* markers
+ * \param	offset	: distance in bytes between the underlying allocation and
+ * 					  the header
+ * \param	size	: usable size, for TCACHE__CLASS_MAPPED the mapping length
+ * ****************************************************************************/
+struct tcache_hdr {
+	uint32_t cls;
+	uint32_t offset;
+	uint64_t size;
+};
+
+/* *******************************************************************
+ * function declarations
+ * ******************************************************************/
+
+/* ************************************************************************//**
+ * \brief	Allocate a zero initialized block of at least _size bytes
+ *
+ * \param	_size	: requested number of bytes
+ * \return	pointer to the block or NULL if out of memory
+ * ****************************************************************************/
+void* tcache__alloc(size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Allocate an uninitialized block of at least _size bytes
+ *
+ * \param	_size	: requested number of bytes
+ * \return	pointer to the block or NULL if out of memory
+ * ****************************************************************************/
+void* tcache__alloc_uninit(size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Resize a block, the content up to the smaller size is preserved
+ *
+ * 	Blocks which stay within their size class are returned unchanged.
+ * 	Bytes beyond the old size are not initialized.
+ *
+ * \param	_mem	: block to resize, NULL allocates a new block
+ * \param	_size	: requested number of bytes
+ * \return	pointer to the block or NULL if out of memory, _mem is kept then
+ * ****************************************************************************/
+void* tcache__realloc(void *_mem, size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Allocate a zero initialized block aligned to _align bytes
+ *
+ * \param	_size	: requested number of bytes
+ * \param	_align	: power of two alignment
+ * \return	pointer to the block or NULL if out of memory
+ * ****************************************************************************/
+void* tcache__alloc_aligned(size_t _size, size_t _align);
+
+/* ************************************************************************//**
+ * \brief	Allocate a page aligned block from a dedicated anonymous mapping
+ *
+ * 	A mapping retained by an earlier release is reused if one fits, it is
+ * 	cleared with memset unless its pages were purged with MADV_DONTNEED.
+ * 	A fresh mapping is zero filled by the kernel and advised for
+ * 	transparent huge pages, no memset is performed for it.
+ *
+ * \param	_size	: requested number of bytes
+ * \return	pointer to the block or NULL if out of memory
+ * ****************************************************************************/
+void* tcache__alloc_mapped(size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Allocate _count zero initialized blocks of the same size
+ *
+ * 	The thread cache is refilled at most once for the whole batch.
+ *
+ * \param	_size	: requested number of bytes per block
+ * \param	_mem	: array the blocks are passed to
+ * \param	_count	: number of blocks
+ * \return	0 if successful, or -1 if out of memory, nothing is allocated then
+ * ****************************************************************************/
+int tcache__alloc_bulk(size_t _size, void **_mem, unsigned int _count);
+
+/* ************************************************************************//**
+ * \brief	Release an array of blocks
+ *
+ * 	Surplus blocks are handed to the central heap once per size class
+ * 	and not once per block.
+ *
+ * \param	_mem	: blocks to release, NULL entries are ignored
+ * \param	_count	: number of entries of _mem
+ * ****************************************************************************/
+void tcache__free_bulk(void **_mem, unsigned int _count);
+
+/* ************************************************************************//**
+ * \brief	Number of bytes usable behind a block pointer
+ *
+ * \param	_mem	: block allocated by any tcache__alloc*() routine
+ * \return	usable size in bytes
+ * ****************************************************************************/
+size_t tcache__usable_size(const void *_mem);
+
+/* ************************************************************************//**
+ * \brief	Release a block allocated by any tcache__alloc*() routine
+ *
+ * \param	_mem	: block to release, NULL is ignored
+ * ****************************************************************************/
+void tcache__free(void *_mem);
+
+/* ************************************************************************//**
+ * \brief	Release a block whose requested size is known by the caller
+ *
+ * \param	_mem	: block allocated by tcache__alloc(), tcache__alloc_uninit()
+ * 					  or tcache__realloc(), NULL is ignored
+ * \param	_size	: size passed at the allocation or the last resize
+ * ****************************************************************************/
+void tcache__free_sized(void *_mem, size_t _size);
+
+/* ************************************************************************//**
+ * \brief	Return the pages of idle free memory to the system
+ *
+ * 	Free blocks of at least two pages and released TCACHE__CLASS_MAPPED
+ * 	blocks are retained for reuse. A decay step advises the pages of what
+ * 	stayed unused for a whole step with MADV_DONTNEED (or MADV_FREE) and
+ * 	unmaps mappings which stayed unused for another step.
+ *
+ * \param	_flags	: TCACHE__PURGE_* flags, 0 for a decay step
+ * ****************************************************************************/
+void tcache__purge(unsigned int _flags);
+
+/* ************************************************************************//**
+ * \brief	Run a decay step if the decay period elapsed since the last one
+ *
+ * 	Called from the release paths, so a process which keeps allocating
+ * 	purges without a background thread.
+ * ****************************************************************************/
+void tcache__purge_tick(void);
+
+/* ************************************************************************//**
+ * \brief	Configure the retention of free memory
+ *
+ * \param	_decay_ms	: period of the decay steps, 0 retains nothing
+ * \param	_ceiling		: retained bytes above which all dirty memory is purged
+ * \param	_lazy		: use MADV_FREE instead of MADV_DONTNEED
+ * ****************************************************************************/
+void tcache__purge_configure(unsigned int _decay_ms, size_t _ceiling, int _lazy);
+
+/* ************************************************************************//**
+ * \brief	Read the purge counters
+ * ****************************************************************************/
+void tcache__purge_stats(struct mem_purge_stats *_stats);
+
+#endif /* LIB_CONVENTION__TCACHE_H_ */
@@ -0,0 +1,322 @@
+/*
+ * This file is part of the EMBTOM project
+ * Copyright (c) 2018-2020 Thomas Willetal
+ * (https://github.com/embtom)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/* *******************************************************************
+ * includes
+ * ******************************************************************/
+/* c-runtime */
+#include <stdint.h>
+
+/* system */
+#ifdef CONFIG__FREERTOS_ALLOC
+	#include <FreeRTOS.h>
+	#include <task.h>
+#else
+	#include <time.h>
+#endif
+
+/* own libs */
+#include <lib_convention__errno.h>
+#include <lib_convention__macro.h>
+#include <lib_convention__ilist.h>
+#include <lib_convention__timer_wheel.h>
+
+/* *******************************************************************
+ * defines
+ * ******************************************************************/
+#define TIMER_WHEEL__SHIFT(_level)		((_level) * TIMER_WHEEL__SLOT_BITS)
+#define TIMER_WHEEL__INDEX(_tick, _level)	\
+			((unsigned int)((_tick) >> TIMER_WHEEL__SHIFT(_level)) & (TIMER_WHEEL__SLOTS - 1))
+
+/* *******************************************************************
+ * static function declarations
+ * ******************************************************************/
+static void timer_wheel__place(struct timer_wheel *_wheel, struct timer_wheel_timer *_timer);
+static void timer_wheel__unlink(struct timer_wheel *_wheel, struct timer_wheel_timer *_timer);
+static void timer_wheel__take(struct timer_wheel *_wheel, unsigned int _level, unsigned int _index,
+							  struct ilist *_to);
+static uint64_t timer_wheel__next(const struct timer_wheel *_wheel);
+
+/* *******************************************************************
+ * function definition
+ * ******************************************************************/
+
+int timer_wheel__init(struct timer_wheel *_wheel, uint64_t _now)
+{
+	unsigned int i;
+
+	if (_wheel == NULL) {
+		return -EPAR_NULL;
+	}
+
+	_wheel->tick = _now;
+	for (i = 0; i < TIMER_WHEEL__LEVELS; i++) {
+		_wheel->pending[i] = 0;
+	}
+	for (i = 0; i < (TIMER_WHEEL__LEVELS * TIMER_WHEEL__SLOTS); i++) {
+		ilist__init(&_wheel->slots[i]);
+	}
+	return EOK;
+}
+
+void timer_wheel__timer_init(struct timer_wheel_timer *_timer, timer_wheel_cb_t _callback, void *_ctx)
+{
+	_timer->node.next = &_timer->node;
+	_timer->node.prev = &_timer->node;
+	_timer->expires = 0;
+	_timer->callback = _callback;
+	_timer->ctx = _ctx;
+	_timer->slot = 0;
+}
+
+int timer_wheel__arm(struct timer_wheel *_wheel, struct timer_wheel_timer *_timer, uint64_t _expires)
+{
+	if ((_wheel == NULL) || (_timer == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	if (timer_wheel__armed(_timer)) {
+		timer_wheel__unlink(_wheel, _timer);
+	}
+	_timer->expires = _expires;
+	timer_wheel__place(_wheel, _timer);
+	return EOK;
+}
+
+int timer_wheel__cancel(struct timer_wheel *_wheel, struct timer_wheel_timer *_timer)
+{
+	if ((_wheel == NULL) || (_timer == NULL)) {
+		return -EPAR_NULL;
+	}
+	if (!timer_wheel__armed(_timer)) {
+		return -ESTD_NOENT;
+	}
+
+	timer_wheel__unlink(_wheel, _timer);
+	return EOK;
+}
+
+int timer_wheel__advance(struct timer_wheel *_wheel, uint64_t _now, struct ilist *_expired)
+{
+	struct ilist_node *node, *tmp;
+	struct ilist batch, parked;
+	unsigned int level;
+	uint64_t tick;
+
+	if ((_wheel == NULL) || (_expired == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	ilist__init(&parked);
+	for (tick = timer_wheel__next(_wheel); (tick <= _now) && (tick != UINT64_MAX); tick = timer_wheel__next(_wheel)) {
+		/* ticks without an occupied slot are skipped */
+		_wheel->tick = tick;
+
+		/* move the timers of the upper levels which turned one level down */
+		for (level = TIMER_WHEEL__LEVELS - 1; level > 0; level--) {
+			if (_wheel->pending[level] & (1ULL << TIMER_WHEEL__INDEX(tick, level))) {
+				ilist__init(&batch);
+				timer_wheel__take(_wheel, level, TIMER_WHEEL__INDEX(tick, level), &batch);
+				ILIST__FOREACH_SAFE(&batch, node, tmp) {
+					ilist__remove(node);
+					timer_wheel__place(_wheel, ILIST__ENTRY(node, struct timer_wheel_timer, node));
+				}
+			}
+		}
+
+		ilist__init(&batch);
+		timer_wheel__take(_wheel, 0, TIMER_WHEEL__INDEX(tick, 0), &batch);
+		ILIST__FOREACH_SAFE(&batch, node, tmp) {
+			/* parked beyond the range of the wheel, not due yet */
+			if (ILIST__ENTRY(node, struct timer_wheel_timer, node)->expires > tick) {
+				ilist__remove(node);
+				ilist__push_back(&parked, node);
+			}
+		}
+		ilist__splice(_expired, &batch);
+
+		_wheel->tick = tick + 1;
+		while ((node = ilist__pop_front(&parked)) != NULL) {
+			timer_wheel__place(_wheel, ILIST__ENTRY(node, struct timer_wheel_timer, node));
+		}
+	}
+
+	if (_wheel->tick <= _now) {
+		_wheel->tick = _now + 1;
+	}
+	return EOK;
+}
+
+int timer_wheel__expire(struct timer_wheel *_wheel, uint64_t _now)
+{
+	struct timer_wheel_timer *timer;
+	struct ilist_node *node;
+	struct ilist expired;
+	int ret, count = 0;
+
+	ilist__init(&expired);
+	ret = timer_wheel__advance(_wheel, _now, &expired);
+	if (ret < EOK) {
+		return ret;
+	}
+
+	/* the list is not touched by the callbacks except for cancels */
+	while ((node = ilist__pop_front(&expired)) != NULL) {
+		timer = ILIST__ENTRY(node, struct timer_wheel_timer, node);
+		if (timer->callback != NULL) {
+			timer->callback(timer, timer->ctx);
+		}
+		count++;
+	}
+	return count;
+}
+
+int timer_wheel__next_expiry(const struct timer_wheel *_wheel, uint64_t *_ticks)
+{
+	uint64_t tick;
+
+	if ((_wheel == NULL) || (_ticks == NULL)) {
+		return -EPAR_NULL;
+	}
+
+	tick = timer_wheel__next(_wheel);
+	if (tick == UINT64_MAX) {
+		return -ESTD_NOENT;
+	}
+	*_ticks = tick;
+	return EOK;
+}
+
+#ifdef CONFIG__FREERTOS_ALLOC
+
+uint64_t timer_wheel__clock(void)
+{
+	TimeOut_t now;
+
+	/*
+	 * The kernel counts the overflows of the tick counter for timeouts.
+	 * Two half shifts stay defined for a 64 bit TickType_t, which never
+	 * overflows and drops the count.
+	 */
+	vTaskSetTimeOutState(&now);
+	return (((uint64_t)now.xOverflowCount << (sizeof(TickType_t) * 4)) << (sizeof(TickType_t) * 4)) |
+		   (uint64_t)now.xTimeOnEntering;
+}
+
+uint64_t timer_wheel__ms_to_ticks(uint64_t _ms)
+{
+	return ((_ms * (uint64_t)configTICK_RATE_HZ) + 999U) / 1000U;
+}
+
+#else
+
+uint64_t timer_wheel__clock(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000U) + ((uint64_t)ts.tv_nsec / 1000000U);
+}
+
+uint64_t timer_wheel__ms_to_ticks(uint64_t _ms)
+{
+	return _ms;
+}
+
+#endif
+
+/* *******************************************************************
+ * static function definition
+ * ******************************************************************/
+
+static void timer_wheel__place(struct timer_wheel *_wheel, struct timer_wheel_timer *_timer)
+{
+	uint64_t expires = _timer->expires;
+	unsigned int level, index;
+	int top;
+
+	if (expires < _wheel->tick) {
+		expires = _wheel->tick;
+	}
+
+	/* the highest bit which differs from the current tick selects the level */
+	top = bit__fls64(expires ^ _wheel->tick);
+	if (top >= (int)(TIMER_WHEEL__SLOT_BITS * TIMER_WHEEL__LEVELS)) {
+		/* park it on the last tick of the current turn of the top level */
+		expires = _wheel->tick | (TIMER_WHEEL__RANGE - 1);
+		top = bit__fls64(expires ^ _wheel->tick);
+	}
+	level = (top < 0) ? 0 : ((unsigned int)top / TIMER_WHEEL__SLOT_BITS);
+
+	index = TIMER_WHEEL__INDEX(expires, level);
+	_timer->slot = (level * TIMER_WHEEL__SLOTS) + index;
+	ilist__push_back(&_wheel->slots[_timer->slot], &_timer->node);
+	_wheel->pending[level] |= 1ULL << index;
+}
+
+static void timer_wheel__unlink(struct timer_wheel *_wheel, struct timer_wheel_timer *_timer)
+{
+	ilist__remove(&_timer->node);
+
+	/* the slot may be stale if the timer sits in an expired list, then it is empty anyway */
+	if (ilist__empty(&_wheel->slots[_timer->slot])) {
+		_wheel->pending[_timer->slot / TIMER_WHEEL__SLOTS] &= ~(1ULL << (_timer->slot % TIMER_WHEEL__SLOTS));
+	}
+}
+
+static void timer_wheel__take(struct timer_wheel *_wheel, unsigned int _level, unsigned int _index,
+							  struct ilist *_to)
+{
+	ilist__splice(_to, &_wheel->slots[(_level * TIMER_WHEEL__SLOTS) + _index]);
+	_wheel->pending[_level] &= ~(1ULL << _index);
+}
+
+static uint64_t timer_wheel__next(const struct timer_wheel *_wheel)
+{
+	uint64_t next = UINT64_MAX, tick, bits;
+	unsigned int level, index;
+
+	for (level = 0; level < TIMER_WHEEL__LEVELS; level++) {
+		/*
+		 * Slots behind the current one are never occupied: a timer shares
+		 * all bits above its level with the tick it was placed at.
+		 */
+		index = TIMER_WHEEL__INDEX(_wheel->tick, level);
+		bits = _wheel->pending[level] & (~0ULL << index);
+		if (bits == 0) {
+			continue;
+		}
+
+		tick = _wheel->tick & ~BITMASK(TIMER_WHEEL__SHIFT(level + 1));
+		tick |= (uint64_t)bit__ctz64(bits) << TIMER_WHEEL__SHIFT(level);
+		if (tick < _wheel->tick) {
+			tick = _wheel->tick;
+		}
+		if (tick < next) {
+			next = tick;
+		}
+	}
+	return next;
+}